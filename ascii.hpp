@@ -0,0 +1,139 @@
+#ifndef BIOVOLTRON_ASCII
+#define BIOVOLTRON_ASCII
+
+#include <cstddef>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+
+/*
+
+namespace biovoltron
+{
+
+// Container is base_vector or vector<uint2_t>; A=0 C=1 G=2 T/U=3 in either case
+
+template <class Container>
+  void from_ascii(Container& c, std::string_view s);                               // throws invalid_argument
+template <class Container>
+  void from_ascii(Container& c, std::string_view s, std::vector<bool>& soft_mask); // soft_mask[i]: s[i] was lowercase
+
+template <class Container>
+  char* to_ascii(const Container& c, char* out);                                   // writes c.size() chars
+template <class Container>
+  char* to_ascii(const Container& c, const std::vector<bool>& soft_mask, char* out);
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+//  Base codes of the ASCII characters: 0-3 for ACGT (either case, U as T),
+//  4 for any other printable character and 5 for whitespace and control
+//  characters. A code with bit 2 set is not a base.
+inline constexpr std::array<unsigned char, 256> __ascii_to_base = []
+{
+  std::array<unsigned char, 256> t{};
+  for (unsigned c = 0; c != 256; ++c)
+    t[c] = c <= ' ' || c == 127 ? 5 : 4;
+  t['A'] = t['a'] = 0;
+  t['C'] = t['c'] = 1;
+  t['G'] = t['g'] = 2;
+  t['T'] = t['t'] = t['U'] = t['u'] = 3;
+  return t;
+}();
+
+//  The four letters held by each byte of a storage word, lowest slot first.
+inline constexpr std::array<std::array<char, 4>, 256> __byte_to_ascii = []
+{
+  std::array<std::array<char, 4>, 256> t{};
+  for (unsigned b = 0; b != 256; ++b)
+    for (unsigned i = 0; i != 4; ++i)
+      t[b][i] = "ACGT"[b >> (2 * i) & 3];
+  return t;
+}();
+
+[[noreturn]] inline void __throw_invalid_base(std::size_t pos, char ch)
+{throw std::invalid_argument("from_ascii: invalid base '" + std::string(1, ch) + "' at " + std::to_string(pos));}
+
+//  Packs s into c one storage word at a time. Each word's characters are
+//  looked up together and checked once; on a character that is not a base
+//  c is cleared and invalid_argument is thrown.
+template <class Container>
+void from_ascii(Container& c, std::string_view s)
+{
+  typedef typename Container::size_type size_type;
+  constexpr unsigned per_word = sizeof(size_type) * CHAR_BIT / 2;
+  c.resize(s.size());
+  size_type* seg = std::to_address(c.data());
+  for (size_type i = 0; i < s.size(); i += per_word)
+  {
+    const size_type n = std::min<size_type>(per_word, s.size() - i);
+    size_type w = 0;
+    unsigned char bad = 0;
+    for (size_type j = 0; j != n; ++j)
+    {
+      const unsigned char b = __ascii_to_base[static_cast<unsigned char>(s[i + j])];
+      bad |= b;
+      w |= size_type(b & 3) << (2 * j);
+    }
+    if (bad & 4)
+    {
+      c.clear();
+      for (size_type j = i;; ++j)
+        if (__ascii_to_base[static_cast<unsigned char>(s[j])] & 4)
+          __throw_invalid_base(j, s[j]);
+    }
+    seg[i / per_word] = w;
+  }
+}
+
+template <class Container>
+void from_ascii(Container& c, std::string_view s, std::vector<bool>& soft_mask)
+{
+  from_ascii(c, s);
+  soft_mask.assign(s.size(), false);
+  for (std::size_t i = 0; i != s.size(); ++i)
+    if (s[i] & 0x20)
+      soft_mask[i] = true;
+}
+
+//  Unpacks c into out, four letters per table lookup, and returns the end
+//  of the written characters. No terminator is added.
+template <class Container>
+char* to_ascii(const Container& c, char* out)
+{
+  typedef typename Container::size_type size_type;
+  constexpr unsigned per_word = sizeof(size_type) * CHAR_BIT / 2;
+  const size_type* seg = std::to_address(c.data());
+  const size_type n = c.size();
+  size_type i = 0;
+  for (; n - i >= per_word; i += per_word, ++seg)
+    for (unsigned j = 0; j != sizeof(size_type); ++j)
+      std::memcpy(out + i + 4 * j, __byte_to_ascii[*seg >> (CHAR_BIT * j) & 0xFF].data(), 4);
+  for (unsigned j = 0; i != n; ++i, ++j)
+    out[i] = "ACGT"[*seg >> (2 * j) & 3];
+  return out + n;
+}
+
+template <class Container>
+char* to_ascii(const Container& c, const std::vector<bool>& soft_mask, char* out)
+{
+  char* last = to_ascii(c, out);
+  for (std::size_t i = 0; i != soft_mask.size() && i != c.size(); ++i)
+    if (soft_mask[i])
+      out[i] |= 0x20;
+  return last;
+}
+
+}
+
+#endif //BIOVOLTRON_ASCII
@@ -0,0 +1,172 @@
+#ifndef BIOVOLTRON_BASE_SPAN
+#define BIOVOLTRON_BASE_SPAN
+
+#include <cstddef>
+#include <compare>
+#include <iterator>
+#include <ranges>
+#include <vector>
+#include <algorithm>
+#include "uint2_t.hpp"
+#include "base_vector.hpp"
+
+/*
+
+A window of packed elements starting at any element offset, not only at a
+word boundary. The iterators are the container's own, so every word-level
+algorithm (copy, fill, count, histogram, mismatch, equal, hamming, ...)
+applies to a span unchanged and deals with a misaligned start by shifting
+two neighbouring words together.
+
+namespace biovoltron
+{
+
+template <class Iterator>
+class packed_span
+{
+ public:
+  typedef Iterator                                         iterator;
+  typedef std::reverse_iterator<iterator>                  reverse_iterator;
+  typedef typename std::iterator_traits<Iterator>::value_type      value_type;
+  typedef typename std::iterator_traits<Iterator>::reference       reference;
+  typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+  typedef std::size_t                                      size_type;
+
+  static constexpr size_type npos = -1;
+
+  packed_span() noexcept;
+  packed_span(iterator first, size_type n) noexcept;
+  packed_span(iterator first, iterator last) noexcept;
+  template <class Container>  // base_vector, base_vector_view, vector<uint2_t>, ...
+  packed_span(Container& c) noexcept;
+  template <class Container>
+  packed_span(Container& c, size_type pos, size_type n = npos) noexcept;
+  template <class It>
+  packed_span(const packed_span<It>& s) noexcept;  // mutable to const
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+  reverse_iterator rbegin() const noexcept;
+  reverse_iterator rend() const noexcept;
+
+  size_type size() const noexcept;
+  bool empty() const noexcept;
+
+  reference operator[](size_type i) const;
+  reference front() const;
+  reference back() const;
+
+  packed_span first(size_type n) const;
+  packed_span last(size_type n) const;
+  packed_span subspan(size_type pos, size_type n = npos) const;  // Precondition:  pos <= size()
+};
+
+template <class It1, class It2>
+  bool operator==(const packed_span<It1>& x, const packed_span<It2>& y);
+template <class It1, class It2>
+  std::strong_ordering operator<=>(const packed_span<It1>& x, const packed_span<It2>& y);
+
+typedef packed_span<base_vector::iterator>                       base_span;
+typedef packed_span<base_vector::const_iterator>                 const_base_span;
+typedef packed_span<std::vector<std::uint2_t>::iterator>         uint2_span;
+typedef packed_span<std::vector<std::uint2_t>::const_iterator>   const_uint2_span;
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+template <class Iterator>
+class packed_span
+{
+ public:
+  typedef Iterator                                                 iterator;
+  typedef std::reverse_iterator<iterator>                          reverse_iterator;
+  typedef typename std::iterator_traits<Iterator>::value_type      value_type;
+  typedef typename std::iterator_traits<Iterator>::reference       reference;
+  typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+  typedef std::size_t                                              size_type;
+
+  static constexpr size_type npos = -1;
+
+  packed_span() noexcept : first_(), size_(0) {}
+  packed_span(iterator first, size_type n) noexcept : first_(first), size_(n) {}
+  packed_span(iterator first, iterator last) noexcept
+    : first_(first), size_(static_cast<size_type>(last - first)) {}
+
+  template <class Container>
+    requires requires (Container& c) {{c.begin()} -> std::convertible_to<iterator>;}
+  packed_span(Container& c) noexcept : first_(c.begin()), size_(c.size()) {}
+
+  template <class Container>
+    requires requires (Container& c) {{c.begin()} -> std::convertible_to<iterator>;}
+  packed_span(Container& c, size_type pos, size_type n = npos) noexcept
+    : first_(c.begin() + pos), size_(std::min(n, c.size() - pos)) {}
+
+  template <class It>
+    requires (!std::is_same_v<It, Iterator> && std::is_convertible_v<It, Iterator>)
+  packed_span(const packed_span<It>& s) noexcept : first_(s.begin()), size_(s.size()) {}
+
+  iterator begin() const noexcept {return first_;}
+  iterator end() const noexcept {return first_ + size_;}
+  reverse_iterator rbegin() const noexcept {return reverse_iterator(end());}
+  reverse_iterator rend() const noexcept {return reverse_iterator(begin());}
+
+  size_type size() const noexcept {return size_;}
+  bool empty() const noexcept {return size_ == 0;}
+
+  reference operator[](size_type i) const {return first_[i];}
+  reference front() const {return *first_;}
+  reference back() const {return first_[size_ - 1];}
+
+  packed_span first(size_type n) const {return packed_span(first_, n);}
+  packed_span last(size_type n) const {return packed_span(first_ + (size_ - n), n);}
+  packed_span subspan(size_type pos, size_type n = npos) const
+  {return packed_span(first_ + pos, std::min(n, size_ - pos));}
+
+  //  Lets a container compare against a span of its own iterators, which
+  //  heterogeneous lookup through std::equal_to<> needs.
+  friend bool operator==(const packed_span& x, const packed_span& y)
+  {
+    using std::equal;
+    return x.size() == y.size() && equal(x.begin(), x.end(), y.begin());
+  }
+
+ private:
+  iterator  first_;
+  size_type size_;
+};
+
+template <class It1, class It2>
+bool operator==(const packed_span<It1>& x, const packed_span<It2>& y)
+{
+  using std::equal;
+  return x.size() == y.size() && equal(x.begin(), x.end(), y.begin());
+}
+
+template <class It1, class It2>
+std::strong_ordering operator<=>(const packed_span<It1>& x, const packed_span<It2>& y)
+{
+  using std::mismatch;
+  const std::size_t n = std::min(x.size(), y.size());
+  auto [i, j] = mismatch(x.begin(), x.begin() + n, y.begin());
+  if (i == x.begin() + n)
+    return x.size() <=> y.size();
+  return static_cast<unsigned char>(*i) <=> static_cast<unsigned char>(*j);
+}
+
+typedef packed_span<base_vector::iterator>                     base_span;
+typedef packed_span<base_vector::const_iterator>               const_base_span;
+typedef packed_span<std::vector<std::uint2_t>::iterator>       uint2_span;
+typedef packed_span<std::vector<std::uint2_t>::const_iterator> const_uint2_span;
+
+}
+
+template <class Iterator>
+inline constexpr bool std::ranges::enable_borrowed_range<biovoltron::packed_span<Iterator>> = true;
+template <class Iterator>
+inline constexpr bool std::ranges::enable_view<biovoltron::packed_span<Iterator>> = true;
+
+#endif //BIOVOLTRON_BASE_SPAN
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <type_traits>
+#include <concepts>
 #include <iterator>
 #include <cassert>
 #include <limits>
@@ -11,6 +12,10 @@
 #include <stdexcept>
 #include <string>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+#include <functional>
 #include <boost/compressed_pair.hpp>
 
 /*
@@ -118,6 +123,15 @@ class base_vector
   iterator insert(const_iterator position, std::input_iterator auto first, std::input_iterator auto last);
   iterator insert(const_iterator position, initializer_list<value_type> il);
 
+  // word-level: the source is shifted into place a word at a time, and may
+  // be a range of this vector
+  base_vector& append(const base_vector& v);
+  template <class Iterator>
+    base_vector& append(packed_span<Iterator> s);  // base_span or const_base_span
+  iterator splice(const_iterator position, const base_vector& v);
+  template <class Iterator>
+    iterator splice(const_iterator position, packed_span<Iterator> s);
+
   iterator erase(const_iterator position);
   iterator erase(const_iterator first, const_iterator last);
 
@@ -127,6 +141,13 @@ class base_vector
   void resize(size_type sz, value_type x);
   void swap(base_vector&) noexcept;
   void flip() noexcept;
+  void reverse_complement() noexcept;
+  size_type count(value_type x) const noexcept;
+  std::array<size_type, 4> histogram() const noexcept;
+
+  // n <= bases per word elements from pos in the low bits, element pos lowest
+  storage_type extract(size_type pos, unsigned n) const noexcept;
+  void deposit(size_type pos, unsigned n, storage_type bits) noexcept;
 
   bool __invariants() const;
 };
@@ -134,6 +155,8 @@ class base_vector
 bool operator== (const base_vector& x, const base_vector& y);
 auto operator<=>(const base_vector& x, const base_vector& y);
 
+base_vector reverse_complement(const base_vector& x);
+
 void swap(base_vector& x, base_vector& y)
     noexcept(noexcept(x.swap(y)));
 
@@ -146,6 +169,9 @@ namespace biovoltron
 
 template <class Cp, bool IsConst, typename Cp::__storage_type = 0> class base_iterator;
 template <class Cp> class base_const_reference;
+template <class Iterator> struct segmented_iterator_traits;
+template <class Iterator> class packed_span;
+class base_vector_view;
 
 template <class Cp>
 class base_reference
@@ -208,9 +234,11 @@ class base_iterator
   typedef std::conditional_t<IsConst, base_const_reference<Cp>, base_reference<Cp> > reference;
   typedef std::random_access_iterator_tag                                            iterator_category;
  private:
+  typedef typename Cp::__storage_type __storage_type;
   typedef std::conditional_t<
     IsConst, typename Cp::__const_storage_pointer, typename Cp::__storage_pointer> __storage_pointer;
   static const unsigned bases_per_word = Cp::bases_per_word;
+  static const unsigned bits_per_word  = bases_per_word * 2;
 
   __storage_pointer seg_;
   unsigned pos_;
@@ -305,8 +333,54 @@ class base_iterator
   friend class base_reference<Cp>;
   friend class base_const_reference<Cp>;
   friend class base_iterator<Cp, true>;
+  friend class base_vector_view;
+  friend struct segmented_iterator_traits<base_iterator>;
+
+  template <class Dp, bool IC>
+  friend base_iterator<Dp, false> __copy_aligned(base_iterator<Dp, IC> first, base_iterator<Dp, IC> last,
+                                                 base_iterator<Dp, false> result);
+  template <class Dp, bool IC>
+  friend base_iterator<Dp, false> __copy_unaligned(base_iterator<Dp, IC> first, base_iterator<Dp, IC> last,
+                                                   base_iterator<Dp, false> result);
+  template <class Dp, bool IC>
+  friend base_iterator<Dp, false> __copy(base_iterator<Dp, IC> first, base_iterator<Dp, IC> last,
+                                         base_iterator<Dp, false> result);
+  template <class Dp, bool IC>
+  friend base_iterator<Dp, false> __copy_backward_aligned(base_iterator<Dp, IC> first, base_iterator<Dp, IC> last,
+                                                          base_iterator<Dp, false> result);
+  template <class Dp, bool IC>
+  friend base_iterator<Dp, false> __copy_backward_unaligned(base_iterator<Dp, IC> first, base_iterator<Dp, IC> last,
+                                                            base_iterator<Dp, false> result);
+  template <class Dp, bool IC>
+  friend base_iterator<Dp, false> __copy_backward(base_iterator<Dp, IC> first, base_iterator<Dp, IC> last,
+                                                  base_iterator<Dp, false> result);
+  template <class Dp>
+  friend void __fill_n(base_iterator<Dp, false> first, typename Dp::size_type n, unsigned char x);
+  template <class Dp, bool IC>
+  friend typename base_iterator<Dp, IC>::difference_type
+  __count(base_iterator<Dp, IC> first, typename Dp::size_type n, unsigned char x);
+  template <class Dp, bool IC>
+  friend std::array<typename Dp::size_type, 4> __histogram(base_iterator<Dp, IC> first, typename Dp::size_type n);
+  template <class Dp, bool IC1, bool IC2>
+  friend std::pair<base_iterator<Dp, IC1>, base_iterator<Dp, IC2>>
+  __mismatch(base_iterator<Dp, IC1> first1, base_iterator<Dp, IC1> last1, base_iterator<Dp, IC2> first2);
+  template <class Dp, bool IC1, bool IC2>
+  friend bool __equal_aligned(base_iterator<Dp, IC1> first1, base_iterator<Dp, IC1> last1, base_iterator<Dp, IC2> first2);
+  template <class Dp, bool IC1, bool IC2>
+  friend bool __equal(base_iterator<Dp, IC1> first1, base_iterator<Dp, IC1> last1, base_iterator<Dp, IC2> first2);
+  template <class Dp, bool IC>
+  friend unsigned __slot(base_iterator<Dp, IC> it) noexcept;
+  template <class Dp, bool IC>
+  friend std::size_t __hash(base_iterator<Dp, IC> first, typename Dp::size_type n) noexcept;
+  template <class Dp, bool IC1, bool IC2>
+  friend typename Dp::size_type __hamming(base_iterator<Dp, IC1> first1, typename Dp::size_type n,
+                                          base_iterator<Dp, IC2> first2, typename Dp::size_type limit);
 };
 
+//  Slot of the element it refers to within its storage word.
+template <class Cp, bool IsConst>
+inline unsigned __slot(base_iterator<Cp, IsConst> it) noexcept {return it.pos_;}
+
 template <class Cp>
 void swap(base_reference<Cp> x, base_reference<Cp> y) noexcept
 {
@@ -331,6 +405,619 @@ void swap(base_reference<Cp> x, unsigned char& y) noexcept
   y = t;
 }
 
+//  Reverses the order of the 2-bit slots of w by swapping ever larger
+//  blocks: neighbouring slots, then nibbles, then bytes and so on.
+template <class StorageType>
+inline StorageType __reverse_slots(StorageType w) noexcept
+{
+  const unsigned bits_per_word = sizeof(StorageType) * CHAR_BIT;
+  unsigned k = 2;
+  for (; k < CHAR_BIT; k <<= 1)
+  {
+    const StorageType m = ~StorageType(0) / ((StorageType(1) << k) + 1);
+    w = ((w >> k) & m) | ((w & m) << k);
+  }
+#if defined(__GNUC__)
+  if constexpr (sizeof(StorageType) == 8)
+    return __builtin_bswap64(w);
+#endif
+  for (; k < bits_per_word; k <<= 1)
+  {
+    const StorageType m = ~StorageType(0) / ((StorageType(1) << k) + 1);
+    w = ((w >> k) & m) | ((w & m) << k);
+  }
+  return w;
+}
+
+//  Returns the nb bits starting at bit ctz of seg in the low bits of a word,
+//  reading the following word only when the range spills into it.
+//  Precondition:  0 < nb <= bits per word
+template <class StorageType, class StoragePointer>
+inline StorageType __load_word(StoragePointer seg, unsigned ctz, unsigned nb) noexcept
+{
+  const unsigned bits_per_word = sizeof(StorageType) * CHAR_BIT;
+  StorageType w = *seg >> ctz;
+  if (ctz + nb > bits_per_word)
+    w |= seg[1] << (bits_per_word - ctz);
+  if (nb < bits_per_word)
+    w &= ~(~StorageType(0) << nb);
+  return w;
+}
+
+//  Writes the low nb bits of w at bit ctz of seg, spilling into the
+//  following word when the range crosses it.
+//  Precondition:  0 < nb <= bits per word
+template <class StorageType, class StoragePointer>
+inline void __store_word(StoragePointer seg, unsigned ctz, unsigned nb, StorageType w) noexcept
+{
+  const unsigned bits_per_word = sizeof(StorageType) * CHAR_BIT;
+  const StorageType m = nb < bits_per_word ? ~(~StorageType(0) << nb) : ~StorageType(0);
+  w &= m;
+  *seg = (*seg & ~(m << ctz)) | w << ctz;
+  if (ctz + nb > bits_per_word)
+  {
+    const unsigned s = bits_per_word - ctz;
+    seg[1] = (seg[1] & ~(m >> s)) | w >> s;
+  }
+}
+
+// copy
+
+template <class Cp, bool IsConst>
+base_iterator<Cp, false> __copy_aligned(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                        base_iterator<Cp, false> result)
+{
+  typedef base_iterator<Cp, IsConst>    In;
+  typedef typename In::difference_type difference_type;
+  typedef typename In::__storage_type  __storage_type;
+  const int bits_per_word = In::bits_per_word;
+  difference_type n = (last - first) * 2;
+  if (n > 0)
+  {
+    // do first word
+    if (first.pos_ != 0)
+    {
+      unsigned ctz = first.pos_ * 2;
+      unsigned clz = bits_per_word - ctz;
+      difference_type dn = std::min(static_cast<difference_type>(clz), n);
+      n -= dn;
+      __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+      __storage_type b = *first.seg_ & m;
+      *result.seg_ &= ~m;
+      *result.seg_ |= b;
+      result.seg_ += (dn + ctz) / bits_per_word;
+      result.pos_ = static_cast<unsigned>((dn + ctz) % bits_per_word) / 2;
+      ++first.seg_;
+      // first.pos_ = 0;
+    }
+    // first.pos_ == 0;
+    // do middle words
+    difference_type nw = n / bits_per_word;
+    std::copy_n(first.seg_, nw, result.seg_);
+    n -= nw * bits_per_word;
+    result.seg_ += nw;
+    // do last word
+    if (n > 0)
+    {
+      first.seg_ += nw;
+      __storage_type m = ~__storage_type(0) >> (bits_per_word - n);
+      __storage_type b = *first.seg_ & m;
+      *result.seg_ &= ~m;
+      *result.seg_ |= b;
+      result.pos_ = static_cast<unsigned>(n / 2);
+    }
+  }
+  return result;
+}
+
+template <class Cp, bool IsConst>
+base_iterator<Cp, false> __copy_unaligned(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                          base_iterator<Cp, false> result)
+{
+  typedef base_iterator<Cp, IsConst>    In;
+  typedef typename In::difference_type difference_type;
+  typedef typename In::__storage_type  __storage_type;
+  const int bits_per_word = In::bits_per_word;
+  difference_type n = (last - first) * 2;
+  if (n > 0)
+  {
+    unsigned ctz_f = first.pos_ * 2;
+    unsigned ctz_r = result.pos_ * 2;
+    // do first word
+    if (ctz_f != 0)
+    {
+      unsigned clz_f = bits_per_word - ctz_f;
+      difference_type dn = std::min(static_cast<difference_type>(clz_f), n);
+      n -= dn;
+      __storage_type m = (~__storage_type(0) << ctz_f) & (~__storage_type(0) >> (clz_f - dn));
+      __storage_type b = *first.seg_ & m;
+      unsigned clz_r = bits_per_word - ctz_r;
+      difference_type ddn = std::min(dn, static_cast<difference_type>(clz_r));
+      m = (~__storage_type(0) << ctz_r) & (~__storage_type(0) >> (clz_r - ddn));
+      *result.seg_ &= ~m;
+      if (ctz_r > ctz_f)
+        *result.seg_ |= b << (ctz_r - ctz_f);
+      else
+        *result.seg_ |= b >> (ctz_f - ctz_r);
+      result.seg_ += (ddn + ctz_r) / bits_per_word;
+      ctz_r = static_cast<unsigned>((ddn + ctz_r) % bits_per_word);
+      dn -= ddn;
+      if (dn > 0)
+      {
+        m = ~__storage_type(0) >> (bits_per_word - dn);
+        *result.seg_ &= ~m;
+        *result.seg_ |= b >> (ctz_f + ddn);
+        ctz_r = static_cast<unsigned>(dn);
+      }
+      ++first.seg_;
+      // ctz_f = 0;
+    }
+    // ctz_f == 0;
+    // do middle words
+    unsigned clz_r = bits_per_word - ctz_r;
+    __storage_type m = ~__storage_type(0) << ctz_r;
+    for (; n >= bits_per_word; n -= bits_per_word, ++first.seg_)
+    {
+      __storage_type b = *first.seg_;
+      *result.seg_ &= ~m;
+      *result.seg_ |= b << ctz_r;
+      ++result.seg_;
+      *result.seg_ &= m;
+      *result.seg_ |= b >> clz_r;
+    }
+    // do last word
+    if (n > 0)
+    {
+      m = ~__storage_type(0) >> (bits_per_word - n);
+      __storage_type b = *first.seg_ & m;
+      difference_type dn = std::min(n, static_cast<difference_type>(clz_r));
+      m = (~__storage_type(0) << ctz_r) & (~__storage_type(0) >> (clz_r - dn));
+      *result.seg_ &= ~m;
+      *result.seg_ |= b << ctz_r;
+      result.seg_ += (dn + ctz_r) / bits_per_word;
+      ctz_r = static_cast<unsigned>((dn + ctz_r) % bits_per_word);
+      n -= dn;
+      if (n > 0)
+      {
+        m = ~__storage_type(0) >> (bits_per_word - n);
+        *result.seg_ &= ~m;
+        *result.seg_ |= b >> dn;
+        ctz_r = static_cast<unsigned>(n);
+      }
+    }
+    result.pos_ = ctz_r / 2;
+  }
+  return result;
+}
+
+template <class Cp, bool IsConst>
+inline base_iterator<Cp, false> __copy(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                       base_iterator<Cp, false> result)
+{
+  if (first.pos_ == result.pos_)
+    return __copy_aligned(first, last, result);
+  return __copy_unaligned(first, last, result);
+}
+
+// copy_backward
+
+template <class Cp, bool IsConst>
+base_iterator<Cp, false> __copy_backward_aligned(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                                 base_iterator<Cp, false> result)
+{
+  typedef base_iterator<Cp, IsConst>    In;
+  typedef typename In::difference_type difference_type;
+  typedef typename In::__storage_type  __storage_type;
+  const int bits_per_word = In::bits_per_word;
+  difference_type n = (last - first) * 2;
+  if (n > 0)
+  {
+    // do first word
+    if (last.pos_ != 0)
+    {
+      unsigned ctz = last.pos_ * 2;
+      difference_type dn = std::min(static_cast<difference_type>(ctz), n);
+      n -= dn;
+      unsigned clz = bits_per_word - ctz;
+      __storage_type m = (~__storage_type(0) << (ctz - dn)) & (~__storage_type(0) >> clz);
+      __storage_type b = *last.seg_ & m;
+      *result.seg_ &= ~m;
+      *result.seg_ |= b;
+      result.pos_ = static_cast<unsigned>(ctz - dn) / 2;
+      // last.pos_ = 0
+    }
+    // last.pos_ == 0 || n == 0
+    // result.pos_ == 0 || n == 0
+    // do middle words
+    difference_type nw = n / bits_per_word;
+    std::copy_backward(last.seg_ - nw, last.seg_, result.seg_);
+    result.seg_ -= nw;
+    last.seg_ -= nw;
+    n -= nw * bits_per_word;
+    // do last word
+    if (n > 0)
+    {
+      __storage_type m = ~__storage_type(0) << (bits_per_word - n);
+      __storage_type b = *--last.seg_ & m;
+      *--result.seg_ &= ~m;
+      *result.seg_ |= b;
+      result.pos_ = static_cast<unsigned>(bits_per_word - n) / 2;
+    }
+  }
+  return result;
+}
+
+template <class Cp, bool IsConst>
+base_iterator<Cp, false> __copy_backward_unaligned(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                                   base_iterator<Cp, false> result)
+{
+  typedef base_iterator<Cp, IsConst>    In;
+  typedef typename In::difference_type difference_type;
+  typedef typename In::__storage_type  __storage_type;
+  const int bits_per_word = In::bits_per_word;
+  difference_type n = (last - first) * 2;
+  if (n > 0)
+  {
+    unsigned ctz_l = last.pos_ * 2;
+    unsigned ctz_r = result.pos_ * 2;
+    // do first word
+    if (ctz_l != 0)
+    {
+      difference_type dn = std::min(static_cast<difference_type>(ctz_l), n);
+      n -= dn;
+      unsigned clz_l = bits_per_word - ctz_l;
+      __storage_type m = (~__storage_type(0) << (ctz_l - dn)) & (~__storage_type(0) >> clz_l);
+      __storage_type b = *last.seg_ & m;
+      difference_type ddn = std::min(dn, static_cast<difference_type>(ctz_r));
+      if (ddn > 0)
+      {
+        m = (~__storage_type(0) << (ctz_r - ddn)) & (~__storage_type(0) >> (bits_per_word - ctz_r));
+        *result.seg_ &= ~m;
+        if (ctz_r > ctz_l)
+          *result.seg_ |= b << (ctz_r - ctz_l);
+        else
+          *result.seg_ |= b >> (ctz_l - ctz_r);
+        ctz_r -= static_cast<unsigned>(ddn);
+        dn -= ddn;
+      }
+      if (dn > 0)
+      {
+        // ctz_r == 0
+        --result.seg_;
+        ctz_r = static_cast<unsigned>(bits_per_word - dn);
+        m = ~__storage_type(0) << ctz_r;
+        *result.seg_ &= ~m;
+        ctz_l -= static_cast<unsigned>(dn + ddn);
+        *result.seg_ |= b << (ctz_r - ctz_l);
+      }
+      // ctz_l = 0
+    }
+    // ctz_l == 0 || n == 0
+    // ctz_r != 0 || n == 0
+    // do middle words
+    unsigned clz_r = bits_per_word - ctz_r;
+    __storage_type m = ~(~__storage_type(0) << ctz_r);
+    for (; n >= bits_per_word; n -= bits_per_word)
+    {
+      __storage_type b = *--last.seg_;
+      *result.seg_ &= ~m;
+      *result.seg_ |= b >> clz_r;
+      *--result.seg_ &= m;
+      *result.seg_ |= b << ctz_r;
+    }
+    // do last word
+    if (n > 0)
+    {
+      m = ~__storage_type(0) << (bits_per_word - n);
+      __storage_type b = *--last.seg_ & m;
+      difference_type dn = std::min(n, static_cast<difference_type>(ctz_r));
+      m = (~__storage_type(0) << (ctz_r - dn)) & (~__storage_type(0) >> clz_r);
+      *result.seg_ &= ~m;
+      *result.seg_ |= b >> clz_r;
+      ctz_r -= static_cast<unsigned>(dn);
+      n -= dn;
+      if (n > 0)
+      {
+        // ctz_r == 0
+        --result.seg_;
+        ctz_r = static_cast<unsigned>(bits_per_word - n);
+        m = ~__storage_type(0) << ctz_r;
+        *result.seg_ &= ~m;
+        *result.seg_ |= b << dn;
+      }
+    }
+    result.pos_ = ctz_r / 2;
+  }
+  return result;
+}
+
+template <class Cp, bool IsConst>
+inline base_iterator<Cp, false> __copy_backward(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                                base_iterator<Cp, false> result)
+{
+  if (last.pos_ == result.pos_)
+    return __copy_backward_aligned(first, last, result);
+  return __copy_backward_unaligned(first, last, result);
+}
+
+template <class Cp, bool IsConst>
+inline base_iterator<Cp, false> copy(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                     base_iterator<Cp, false> result)
+{return __copy(first, last, result);}
+
+template <class Cp, bool IsConst>
+inline base_iterator<Cp, false> copy_backward(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+                                              base_iterator<Cp, false> result)
+{return __copy_backward(first, last, result);}
+
+// fill_n
+
+template <class Cp>
+void __fill_n(base_iterator<Cp, false> first, typename Cp::size_type n, unsigned char x)
+{
+  typedef base_iterator<Cp, false>     It;
+  typedef typename It::difference_type difference_type;
+  typedef typename It::__storage_type  __storage_type;
+  const int bits_per_word = It::bits_per_word;
+  // x replicated into every 2-bit slot of a word
+  const __storage_type pattern = ~__storage_type(0) / 3 * x;
+  auto nb = static_cast<difference_type>(n * 2);
+  // do first partial word
+  if (first.pos_ != 0)
+  {
+    unsigned ctz = first.pos_ * 2;
+    unsigned clz = bits_per_word - ctz;
+    difference_type dn = std::min(static_cast<difference_type>(clz), nb);
+    __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+    *first.seg_ = (*first.seg_ & ~m) | (pattern & m);
+    nb -= dn;
+    ++first.seg_;
+  }
+  // do middle whole words
+  difference_type nw = nb / bits_per_word;
+  std::fill_n(first.seg_, nw, pattern);
+  nb -= nw * bits_per_word;
+  // do last partial word
+  if (nb > 0)
+  {
+    first.seg_ += nw;
+    __storage_type m = ~__storage_type(0) >> (bits_per_word - nb);
+    *first.seg_ = (*first.seg_ & ~m) | (pattern & m);
+  }
+}
+
+//  The count and the value are template parameters so that these stay more
+//  specialized than std::fill_n and std::fill for integer literals too.
+template <class Cp, std::integral Size, std::integral T>
+inline base_iterator<Cp, false> fill_n(base_iterator<Cp, false> first, Size n, const T& x)
+{
+  if (n > 0)
+    __fill_n(first, static_cast<typename Cp::size_type>(n), static_cast<unsigned char>(x));
+  return n > 0 ? first + n : first;
+}
+
+template <class Cp, std::integral T>
+inline void fill(base_iterator<Cp, false> first, base_iterator<Cp, false> last, const T& x)
+{biovoltron::fill_n(first, static_cast<typename Cp::size_type>(last - first), x);}
+
+// count
+
+template <class Cp, bool IsConst>
+typename base_iterator<Cp, IsConst>::difference_type
+__count(base_iterator<Cp, IsConst> first, typename Cp::size_type n, unsigned char x)
+{
+  typedef base_iterator<Cp, IsConst>   It;
+  typedef typename It::difference_type difference_type;
+  typedef typename It::__storage_type  __storage_type;
+  const int bits_per_word = It::bits_per_word;
+  // low bit of every 2-bit slot
+  const __storage_type lo_bits = ~__storage_type(0) / 3;
+  const __storage_type pattern = lo_bits * x;
+  difference_type r = 0;
+  auto nb = static_cast<difference_type>(n * 2);
+  // do first partial word
+  if (first.pos_ != 0)
+  {
+    unsigned ctz = first.pos_ * 2;
+    unsigned clz = bits_per_word - ctz;
+    difference_type dn = std::min(static_cast<difference_type>(clz), nb);
+    __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+    __storage_type e = ~(*first.seg_ ^ pattern);
+    r += std::popcount(e & (e >> 1) & lo_bits & m);
+    nb -= dn;
+    ++first.seg_;
+  }
+  // do middle whole words
+  for (; nb >= bits_per_word; ++first.seg_, nb -= bits_per_word)
+  {
+    __storage_type e = ~(*first.seg_ ^ pattern);
+    r += std::popcount(e & (e >> 1) & lo_bits);
+  }
+  // do last partial word
+  if (nb > 0)
+  {
+    __storage_type m = ~__storage_type(0) >> (bits_per_word - nb);
+    __storage_type e = ~(*first.seg_ ^ pattern);
+    r += std::popcount(e & (e >> 1) & lo_bits & m);
+  }
+  return r;
+}
+
+//  x is a template parameter so that this stays more specialized than
+//  std::count for integer literals too; a value no base can hold counts 0.
+template <class Cp, bool IsConst, std::integral T>
+inline typename base_iterator<Cp, IsConst>::difference_type
+count(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, const T& x)
+{
+  if (std::cmp_less(x, 0) || std::cmp_greater(x, 3))
+    return 0;
+  return __count(first, static_cast<typename Cp::size_type>(last - first), static_cast<unsigned char>(x));
+}
+
+// histogram
+
+//  Counts every base in [first, first + n) in one pass.
+//  Per word the high and low bit planes are popcounted separately,
+//  together with their intersection (the 3s); the 1s, 2s and 0s follow.
+template <class Cp, bool IsConst>
+std::array<typename Cp::size_type, 4> __histogram(base_iterator<Cp, IsConst> first, typename Cp::size_type n)
+{
+  typedef base_iterator<Cp, IsConst>   It;
+  typedef typename It::difference_type difference_type;
+  typedef typename It::__storage_type  __storage_type;
+  typedef typename Cp::size_type       size_type;
+  const int bits_per_word = It::bits_per_word;
+  const __storage_type lo_bits = ~__storage_type(0) / 3;
+  size_type hi = 0, lo = 0, both = 0;
+  auto nb = static_cast<difference_type>(n * 2);
+  // do first partial word
+  if (first.pos_ != 0)
+  {
+    unsigned ctz = first.pos_ * 2;
+    unsigned clz = bits_per_word - ctz;
+    difference_type dn = std::min(static_cast<difference_type>(clz), nb);
+    __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+    __storage_type w = *first.seg_ & m;
+    __storage_type h = (w >> 1) & lo_bits, l = w & lo_bits;
+    hi += std::popcount(h);
+    lo += std::popcount(l);
+    both += std::popcount(h & l);
+    nb -= dn;
+    ++first.seg_;
+  }
+  // do middle whole words
+  for (; nb >= bits_per_word; ++first.seg_, nb -= bits_per_word)
+  {
+    __storage_type w = *first.seg_;
+    __storage_type h = (w >> 1) & lo_bits, l = w & lo_bits;
+    hi += std::popcount(h);
+    lo += std::popcount(l);
+    both += std::popcount(h & l);
+  }
+  // do last partial word
+  if (nb > 0)
+  {
+    __storage_type m = ~__storage_type(0) >> (bits_per_word - nb);
+    __storage_type w = *first.seg_ & m;
+    __storage_type h = (w >> 1) & lo_bits, l = w & lo_bits;
+    hi += std::popcount(h);
+    lo += std::popcount(l);
+    both += std::popcount(h & l);
+  }
+  return {n - hi - lo + both, lo - both, hi - both, both};
+}
+
+template <class Cp, bool IsConst>
+inline std::array<typename Cp::size_type, 4> histogram(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last)
+{return __histogram(first, static_cast<typename Cp::size_type>(last - first));}
+
+// mismatch
+
+//  Compares a word's worth of bases at a time; the first differing
+//  base is the lowest differing 2-bit slot of the xor.
+template <class Cp, bool IC1, bool IC2>
+std::pair<base_iterator<Cp, IC1>, base_iterator<Cp, IC2>>
+__mismatch(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2)
+{
+  typedef base_iterator<Cp, IC1>       It;
+  typedef typename It::difference_type difference_type;
+  typedef typename It::__storage_type  __storage_type;
+  const int bits_per_word = It::bits_per_word;
+  difference_type n = (last1 - first1) * 2;
+  unsigned ctz1 = first1.pos_ * 2;
+  unsigned ctz2 = first2.pos_ * 2;
+  // do whole words
+  for (; n >= bits_per_word; n -= bits_per_word, ++first1.seg_, ++first2.seg_)
+  {
+    __storage_type d = __load_word<__storage_type>(first1.seg_, ctz1, bits_per_word)
+                     ^ __load_word<__storage_type>(first2.seg_, ctz2, bits_per_word);
+    if (d != 0)
+    {
+      difference_type i = std::countr_zero(d) / 2;
+      return {first1 + i, first2 + i};
+    }
+  }
+  // do last partial word
+  if (n > 0)
+  {
+    auto nb = static_cast<unsigned>(n);
+    __storage_type d = __load_word<__storage_type>(first1.seg_, ctz1, nb)
+                     ^ __load_word<__storage_type>(first2.seg_, ctz2, nb);
+    difference_type i = d != 0 ? std::countr_zero(d) / 2 : n / 2;
+    return {first1 + i, first2 + i};
+  }
+  return {first1, first2};
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline std::pair<base_iterator<Cp, IC1>, base_iterator<Cp, IC2>>
+mismatch(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2)
+{return __mismatch(first1, last1, first2);}
+
+template <class Cp, bool IC1, bool IC2>
+inline std::pair<base_iterator<Cp, IC1>, base_iterator<Cp, IC2>>
+mismatch(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1,
+         base_iterator<Cp, IC2> first2, base_iterator<Cp, IC2> last2)
+{return __mismatch(first1, first1 + std::min(last1 - first1, last2 - first2), first2);}
+
+// equal
+
+template <class Cp, bool IC1, bool IC2>
+bool __equal_aligned(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2)
+{
+  typedef base_iterator<Cp, IC1>       It;
+  typedef typename It::difference_type difference_type;
+  typedef typename It::__storage_type  __storage_type;
+  const int bits_per_word = It::bits_per_word;
+  difference_type n = (last1 - first1) * 2;
+  if (n > 0)
+  {
+    // do first word
+    if (first1.pos_ != 0)
+    {
+      unsigned ctz = first1.pos_ * 2;
+      unsigned clz = bits_per_word - ctz;
+      difference_type dn = std::min(static_cast<difference_type>(clz), n);
+      n -= dn;
+      __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+      if ((*first2.seg_ & m) != (*first1.seg_ & m))
+        return false;
+      ++first2.seg_;
+      ++first1.seg_;
+      // first1.pos_ = 0;
+      // first2.pos_ = 0;
+    }
+    // do middle words
+    difference_type nw = n / bits_per_word;
+    if (!std::equal(first1.seg_, first1.seg_ + nw, first2.seg_))
+      return false;
+    n -= nw * bits_per_word;
+    // do last word
+    if (n > 0)
+    {
+      first1.seg_ += nw;
+      first2.seg_ += nw;
+      __storage_type m = ~__storage_type(0) >> (bits_per_word - n);
+      if ((*first2.seg_ & m) != (*first1.seg_ & m))
+        return false;
+    }
+  }
+  return true;
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline bool __equal(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2)
+{
+  if (first1.pos_ == first2.pos_)
+    return __equal_aligned(first1, last1, first2);
+  return __mismatch(first1, last1, first2).first == last1;
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline bool equal(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2)
+{return __equal(first1, last1, first2);}
+
+
 template <bool>
 class __base_vector_base_common
 {
@@ -475,6 +1162,16 @@ class base_vector : private __base_vector_base_common<true>
   iterator insert(const_iterator position, std::initializer_list<value_type> il)
   {return insert(position, il.begin(), il.end());}
 
+  base_vector& append(const base_vector& v) {__splice(end(), v.begin(), v.size()); return *this;}
+  template <class Iterator>
+    requires std::is_convertible_v<Iterator, const_iterator>
+  base_vector& append(packed_span<Iterator> s) {__splice(end(), s.begin(), s.size()); return *this;}
+
+  iterator splice(const_iterator position, const base_vector& v) {return __splice(position, v.begin(), v.size());}
+  template <class Iterator>
+    requires std::is_convertible_v<Iterator, const_iterator>
+  iterator splice(const_iterator position, packed_span<Iterator> s) {return __splice(position, s.begin(), s.size());}
+
   iterator erase(const_iterator position);
   iterator erase(const_iterator first, const_iterator last);
 
@@ -485,6 +1182,26 @@ class base_vector : private __base_vector_base_common<true>
 
   void resize(size_type sz, value_type x = 0);
   void flip() noexcept;
+  void reverse_complement() noexcept;
+
+  size_type count(value_type x) const noexcept {return biovoltron::count(begin(), end(), x);}
+  std::array<size_type, 4> histogram() const noexcept {return biovoltron::histogram(begin(), end());}
+
+  //  One funnel shift over the two words holding the range instead of a
+  //  proxy reference per element.
+  //  Precondition:  n <= bases_per_word && pos + n <= size()
+  __storage_type extract(size_type pos, unsigned n) const noexcept
+  {
+    if (n == 0)
+      return 0;
+    return __load_word<__storage_type>(begin_ + pos / bases_per_word, pos % bases_per_word * 2, n * 2);
+  }
+
+  void deposit(size_type pos, unsigned n, __storage_type bits) noexcept
+  {
+    if (n != 0)
+      __store_word(begin_ + pos / bases_per_word, pos % bases_per_word * 2, n * 2, bits);
+  }
 
   bool __invariants() const;
 
@@ -505,6 +1222,7 @@ class base_vector : private __base_vector_base_common<true>
   const_iterator  __make_iter(size_type pos) const noexcept {return const_iterator (begin_ + pos / bases_per_word, pos % bases_per_word);}
 
   iterator __const_iterator_cast(const_iterator p) noexcept {return begin() + (p - cbegin());}
+  iterator __splice(const_iterator position, const_iterator first, size_type n);
 
   void __copy_assign_alloc(const base_vector& v)
   {
@@ -597,14 +1315,15 @@ void base_vector::__construct_at_end(size_type n, value_type x)
 {
   size_type old_size = this->size_;
   this->size_ += n;
-  std::fill_n(__make_iter(old_size), n, x);
+  biovoltron::fill_n(__make_iter(old_size), n, x);
 }
 
 void base_vector::__construct_at_end(std::forward_iterator auto first, std::forward_iterator auto last)
 {
   size_type old_size = this->size_;
   this->size_ += std::distance(first, last);
-  std::copy(first, last, __make_iter(old_size));
+  using std::copy;
+  copy(first, last, __make_iter(old_size));
 }
 
 base_vector::base_vector() noexcept(std::is_nothrow_default_constructible_v<allocator_type>)
@@ -881,7 +1600,7 @@ void base_vector::assign(size_type n, const value_type& x)
       v.size_ = n;
       swap(v);
     }
-    std::fill_n(begin(), n, x);
+    biovoltron::fill_n(begin(), n, x);
   }
   __invalidate_all_iterators();
 }
@@ -965,7 +1684,7 @@ typename base_vector::iterator base_vector::insert(const_iterator position, cons
   {
     const_iterator old_end = end();
     ++size_;
-    std::copy_backward(position, old_end, end());
+    biovoltron::copy_backward(position, old_end, end());
     r = __const_iterator_cast(position);
   }
   else
@@ -973,8 +1692,8 @@ typename base_vector::iterator base_vector::insert(const_iterator position, cons
     base_vector v(__alloc());
     v.reserve(__recommend(size_ + 1));
     v.size_ = size_ + 1;
-    r = std::copy(cbegin(), position, v.begin());
-    std::copy_backward(position, cend(), v.end());
+    r = biovoltron::copy(cbegin(), position, v.begin());
+    biovoltron::copy_backward(position, cend(), v.end());
     swap(v);
   }
   *r = x;
@@ -989,7 +1708,7 @@ typename base_vector::iterator base_vector::insert(const_iterator position, size
   {
     const_iterator old_end = end();
     size_ += n;
-    std::copy_backward(position, old_end, end());
+    biovoltron::copy_backward(position, old_end, end());
     r = __const_iterator_cast(position);
   }
   else
@@ -997,11 +1716,11 @@ typename base_vector::iterator base_vector::insert(const_iterator position, size
     base_vector v(__alloc());
     v.reserve(__recommend(size_ + n));
     v.size_ = size_ + n;
-    r = std::copy(cbegin(), position, v.begin());
-    std::copy_backward(position, cend(), v.end());
+    r = biovoltron::copy(cbegin(), position, v.begin());
+    biovoltron::copy_backward(position, cend(), v.end());
     swap(v);
   }
-  std::fill_n(r, n, x);
+  biovoltron::fill_n(r, n, x);
   return r;
 }
 
@@ -1049,7 +1768,7 @@ typename base_vector::iterator base_vector::insert(const_iterator position, std:
   {
     const_iterator old_end = end();
     size_ += n;
-    std::copy_backward(position, old_end, end());
+    biovoltron::copy_backward(position, old_end, end());
     r = __const_iterator_cast(position);
   }
   else
@@ -1057,18 +1776,59 @@ typename base_vector::iterator base_vector::insert(const_iterator position, std:
     base_vector v(__alloc());
     v.reserve(__recommend(size_ + n));
     v.size_ = size_ + n;
-    r = std::copy(cbegin(), position, v.begin());
-    std::copy_backward(position, cend(), v.end());
+    r = biovoltron::copy(cbegin(), position, v.begin());
+    biovoltron::copy_backward(position, cend(), v.end());
+    swap(v);
+  }
+  using std::copy;
+  copy(first, last, r);
+  return r;
+}
+
+//  Opens a gap of n at position with copy_backward and fills it with copy,
+//  both shifting whole words between the two alignments. A source inside
+//  this vector is read in pieces: what lay past position has moved up by n.
+typename base_vector::iterator base_vector::__splice(const_iterator position, const_iterator first, size_type n)
+{
+  iterator r;
+  size_type c = capacity();
+  if (n <= c && size() <= c - n)
+  {
+    const bool inside = n != 0 && !std::less<>()(first.seg_, begin_) && std::less<>()(first.seg_, begin_ + __cap());
+    const difference_type p = position - cbegin();
+    const difference_type f = inside ? first - cbegin() : 0;
+    const difference_type dn = static_cast<difference_type>(n);
+    const_iterator old_end = end();
+    size_ += n;
+    biovoltron::copy_backward(position, old_end, end());
+    r = __const_iterator_cast(position);
+    if (!inside || f + dn <= p)
+      biovoltron::copy(first, first + dn, r);
+    else if (f >= p)
+      biovoltron::copy(first + dn, first + 2 * dn, r);
+    else
+    {
+      biovoltron::copy(first, position, r);
+      biovoltron::copy(position + dn, first + 2 * dn, r + (p - f));
+    }
+  }
+  else
+  {
+    base_vector v(__alloc());
+    v.reserve(__recommend(size_ + n));
+    v.size_ = size_ + n;
+    r = biovoltron::copy(cbegin(), position, v.begin());
+    biovoltron::copy(first, first + n, r);
+    biovoltron::copy(position, cend(), r + n);
     swap(v);
   }
-  std::copy(first, last, r);
   return r;
 }
 
 typename base_vector::iterator base_vector::erase(const_iterator position)
 {
   iterator r = __const_iterator_cast(position);
-  std::copy(position + 1, this->cend(), r);
+  biovoltron::copy(position + 1, this->cend(), r);
   --size_;
   return r;
 }
@@ -1077,7 +1837,7 @@ typename base_vector::iterator base_vector::erase(const_iterator first, const_it
 {
   iterator r = __const_iterator_cast(first);
   difference_type d = last - first;
-  std::copy(last, this->cend(), r);
+  biovoltron::copy(last, this->cend(), r);
   size_ -= d;
   return r;
 }
@@ -1107,10 +1867,10 @@ void base_vector::resize(size_type sz, value_type x)
       base_vector v(__alloc());
       v.reserve(__recommend(size_ + n));
       v.size_ = size_ + n;
-      r = std::copy(cbegin(), cend(), v.begin());
+      r = biovoltron::copy(cbegin(), cend(), v.begin());
       swap(v);
     }
-    std::fill_n(r, n, x);
+    biovoltron::fill_n(r, n, x);
   }
   else
     size_ = sz;
@@ -1134,6 +1894,35 @@ void base_vector::flip() noexcept
   }
 }
 
+void base_vector::reverse_complement() noexcept
+{
+  if (size_ == 0)
+    return;
+  const size_type nw = __external_cap_to_internal(size_);
+
+  // reverse and complement whole words, swapping from both ends
+  __storage_pointer first = begin_;
+  __storage_pointer last = begin_ + nw - 1;
+  for (; first < last; ++first, --last)
+  {
+    __storage_type t = ~__reverse_slots(*first);
+    *first = ~__reverse_slots(*last);
+    *last = t;
+  }
+  if (first == last)
+    *first = ~__reverse_slots(*first);
+
+  // the unused tail of the last word is now at the front, shift it out
+  const unsigned r = size_ % bases_per_word;
+  if (r != 0)
+  {
+    const unsigned s = (bases_per_word - r) * 2;
+    for (size_type i = 0; i + 1 < nw; ++i)
+      begin_[i] = (begin_[i] >> s) | (begin_[i + 1] << (bases_per_word * 2 - s));
+    begin_[nw - 1] >>= s;
+  }
+}
+
 bool base_vector::__invariants() const
 {
   if (this->begin_ == nullptr)
@@ -1152,10 +1941,22 @@ bool base_vector::__invariants() const
 }
 
 bool operator==(const base_vector& x, const base_vector& y)
-{return x.size() == y.size() && std::equal(x.begin(), x.end(), y.begin());}
+{return x.size() == y.size() && biovoltron::equal(x.begin(), x.end(), y.begin());}
 
 auto operator<=>(const base_vector& x, const base_vector& y)
-{return std::lexicographical_compare_three_way(x.begin(), x.end(), y.begin(), y.end());}
+{
+  auto [i, j] = biovoltron::mismatch(x.begin(), x.end(), y.begin(), y.end());
+  if (i == x.end() || j == y.end())
+    return x.size() <=> y.size();
+  return static_cast<unsigned char>(*i) <=> static_cast<unsigned char>(*j);
+}
+
+base_vector reverse_complement(const base_vector& x)
+{
+  base_vector r(x);
+  r.reverse_complement();
+  return r;
+}
 
 void swap(base_vector& x, base_vector& y) noexcept(noexcept(x.swap(y))) {x.swap(y);}
 
@@ -0,0 +1,279 @@
+#ifndef BIOVOLTRON_BASE_VECTOR_SET
+#define BIOVOLTRON_BASE_VECTOR_SET
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <vector>
+#include <stdexcept>
+#include "base_vector.hpp"
+#include "base_span.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+class base_vector_set
+{
+ public:
+  typedef base_vector::size_type                                size_type;
+  typedef base_vector::difference_type                          difference_type;
+  typedef base_span                                             reference;        // a view of one sequence
+  typedef const_base_span                                       const_reference;
+  typedef const_reference                                       value_type;
+  typedef implementation-defined                                iterator;         // random access
+  typedef implementation-defined                                const_iterator;
+
+  base_vector_set();
+
+  iterator       begin() noexcept;
+  const_iterator begin()  const noexcept;
+  iterator       end() noexcept;
+  const_iterator end()    const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend()   const noexcept;
+
+  size_type size() const noexcept;          // number of sequences
+  bool empty() const noexcept;
+  size_type total_size() const noexcept;    // number of bases over all sequences
+  size_type length(size_type i) const;
+  void reserve(size_type sequences, size_type bases);
+  void shrink_to_fit();
+
+  reference       operator[](size_type i);
+  const_reference operator[](size_type i) const;
+  reference       at(size_type i);
+  const_reference at(size_type i) const;
+  reference       front();
+  const_reference front() const;
+  reference       back();
+  const_reference back() const;
+
+  const base_vector&            bases() const noexcept;    // all sequences back to back
+  const std::vector<size_type>& offsets() const noexcept;  // size() + 1 entries, first is 0
+
+  void push_back(std::forward_iterator auto first, std::forward_iterator auto last);
+  void push_back(const base_vector& v);
+  void push_back(const_reference v);
+  reference emplace_back(size_type n, base_vector::value_type x = 0);
+  void append(std::input_iterator auto first, std::input_iterator auto last);  // *first is a sequence
+  void append(const base_vector_set& s);
+  void pop_back();
+  void clear() noexcept;
+  void swap(base_vector_set& s) noexcept;
+};
+
+bool operator==(const base_vector_set& x, const base_vector_set& y);
+void swap(base_vector_set& x, base_vector_set& y) noexcept;
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+//  Many sequences packed back to back in one base_vector, delimited by an
+//  offsets array, so a whole read set costs two allocations. Elements are
+//  spans over base_vector iterators. The iterators are random access, so
+//  the parallel standard algorithms can walk the set; sequences share
+//  storage words at their ends, so concurrent writes to neighbouring
+//  elements race while concurrent reads are fine. Sources given to
+//  push_back and append must not alias the set.
+class base_vector_set
+{
+ public:
+  typedef base_vector::size_type                             size_type;
+  typedef base_vector::difference_type                       difference_type;
+  typedef base_span                                          reference;
+  typedef const_base_span                                    const_reference;
+  typedef const_reference                                    value_type;
+
+ private:
+  template <bool IsConst>
+  class __iterator
+  {
+    typedef std::conditional_t<IsConst, const base_vector_set, base_vector_set> __set;
+   public:
+    typedef base_vector_set::difference_type                                      difference_type;
+    typedef std::conditional_t<IsConst, base_vector_set::const_reference,
+                                        base_vector_set::reference>               value_type;
+    typedef value_type                                                            reference;
+    typedef void                                                                  pointer;
+    typedef std::random_access_iterator_tag                                       iterator_category;
+
+    __iterator() noexcept : s_(nullptr), i_(0) {}
+    __iterator(const __iterator<false>& it) noexcept : s_(it.s_), i_(it.i_) {}
+
+    reference operator*() const {return (*s_)[i_];}
+    reference operator[](difference_type n) const {return (*s_)[i_ + n];}
+
+    __iterator& operator++() noexcept {++i_; return *this;}
+    __iterator& operator--() noexcept {--i_; return *this;}
+    __iterator operator++(int) noexcept {__iterator t(*this); ++i_; return t;}
+    __iterator operator--(int) noexcept {__iterator t(*this); --i_; return t;}
+    __iterator& operator+=(difference_type n) noexcept {i_ += n; return *this;}
+    __iterator& operator-=(difference_type n) noexcept {i_ -= n; return *this;}
+    __iterator operator+(difference_type n) const noexcept {return __iterator(s_, i_ + n);}
+    __iterator operator-(difference_type n) const noexcept {return __iterator(s_, i_ - n);}
+    friend __iterator operator+(difference_type n, const __iterator& it) noexcept {return it + n;}
+    friend difference_type operator-(const __iterator& x, const __iterator& y) noexcept
+    {return static_cast<difference_type>(x.i_) - static_cast<difference_type>(y.i_);}
+
+    friend bool operator==(const __iterator& x, const __iterator& y) noexcept {return x.i_ == y.i_;}
+    friend auto operator<=>(const __iterator& x, const __iterator& y) noexcept {return x.i_ <=> y.i_;}
+
+   private:
+    __set* s_;
+    size_type i_;
+
+    __iterator(__set* s, size_type i) noexcept : s_(s), i_(i) {}
+
+    friend class base_vector_set;
+    friend class __iterator<true>;
+  };
+
+ public:
+  typedef __iterator<false> iterator;
+  typedef __iterator<true>  const_iterator;
+
+  base_vector_set() : offsets_(1, 0) {}
+
+  iterator       begin()        noexcept {return iterator(this, 0);}
+  const_iterator begin()  const noexcept {return const_iterator(this, 0);}
+  iterator       end()          noexcept {return iterator(this, size());}
+  const_iterator end()    const noexcept {return const_iterator(this, size());}
+  const_iterator cbegin() const noexcept {return begin();}
+  const_iterator cend()   const noexcept {return end();}
+
+  size_type size() const noexcept {return offsets_.size() - 1;}
+  bool empty() const noexcept {return offsets_.size() == 1;}
+  size_type total_size() const noexcept {return bases_.size();}
+  size_type length(size_type i) const {return offsets_[i + 1] - offsets_[i];}
+
+  void reserve(size_type sequences, size_type bases)
+  {
+    offsets_.reserve(sequences + 1);
+    bases_.reserve(bases);
+  }
+
+  void shrink_to_fit()
+  {
+    offsets_.shrink_to_fit();
+    bases_.shrink_to_fit();
+  }
+
+  reference operator[](size_type i)
+  {return reference(bases_.begin() + offsets_[i], bases_.begin() + offsets_[i + 1]);}
+  const_reference operator[](size_type i) const
+  {return const_reference(bases_.begin() + offsets_[i], bases_.begin() + offsets_[i + 1]);}
+
+  reference at(size_type i)
+  {
+    if (i >= size())
+      throw std::out_of_range("base_vector_set");
+    return (*this)[i];
+  }
+
+  const_reference at(size_type i) const
+  {
+    if (i >= size())
+      throw std::out_of_range("base_vector_set");
+    return (*this)[i];
+  }
+
+  reference       front()       {return (*this)[0];}
+  const_reference front() const {return (*this)[0];}
+  reference       back()        {return (*this)[size() - 1];}
+  const_reference back()  const {return (*this)[size() - 1];}
+
+  const base_vector&            bases()   const noexcept {return bases_;}
+  const std::vector<size_type>& offsets() const noexcept {return offsets_;}
+
+  void push_back(std::forward_iterator auto first, std::forward_iterator auto last)
+  {
+    bases_.insert(bases_.end(), first, last);
+    __push_offset();
+  }
+
+  void push_back(const base_vector& v) {push_back(v.begin(), v.end());}
+  void push_back(const_reference v) {push_back(v.begin(), v.end());}
+
+  reference emplace_back(size_type n, base_vector::value_type x = 0)
+  {
+    bases_.resize(bases_.size() + n, x);
+    __push_offset();
+    return back();
+  }
+
+  void append(std::input_iterator auto first, std::input_iterator auto last)
+  {
+    for (; first != last; ++first)
+      push_back(std::ranges::begin(*first), std::ranges::end(*first));
+  }
+
+  //  One word-level copy for all the bases, then the shifted offsets.
+  void append(const base_vector_set& s)
+  {
+    const size_type base = bases_.size();
+    const size_type n = offsets_.size();
+    bases_.insert(bases_.end(), s.bases_.begin(), s.bases_.end());
+    try
+    {
+      offsets_.insert(offsets_.end(), s.offsets_.begin() + 1, s.offsets_.end());
+    }
+    catch (...)
+    {
+      bases_.resize(base);
+      throw;
+    }
+    for (auto it = offsets_.begin() + n; it != offsets_.end(); ++it)
+      *it += base;
+  }
+
+  void pop_back()
+  {
+    offsets_.pop_back();
+    bases_.resize(offsets_.back());
+  }
+
+  void clear() noexcept
+  {
+    bases_.clear();
+    offsets_.resize(1);
+  }
+
+  void swap(base_vector_set& s) noexcept
+  {
+    bases_.swap(s.bases_);
+    offsets_.swap(s.offsets_);
+  }
+
+ private:
+  base_vector            bases_;
+  std::vector<size_type> offsets_;
+
+  //  Closes the sequence just appended to bases_, dropping it on failure.
+  void __push_offset()
+  {
+    try
+    {
+      offsets_.push_back(bases_.size());
+    }
+    catch (...)
+    {
+      bases_.resize(offsets_.back());
+      throw;
+    }
+  }
+};
+
+bool operator==(const base_vector_set& x, const base_vector_set& y)
+{return x.offsets() == y.offsets() && x.bases() == y.bases();}
+
+void swap(base_vector_set& x, base_vector_set& y) noexcept {x.swap(y);}
+
+}
+
+#endif //BIOVOLTRON_BASE_VECTOR_SET
@@ -0,0 +1,267 @@
+#ifndef BIOVOLTRON_BASE_VECTOR_VIEW
+#define BIOVOLTRON_BASE_VECTOR_VIEW
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <array>
+#include <iterator>
+#include <utility>
+#include <string>
+#include <ostream>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "base_vector.hpp"
+
+/*
+
+On-disk layout of a packed sequence, all fields in native byte order:
+
+  offset  size  field
+       0     8  magic       "BVPACK\0\0"
+       8     8  byte_order  0x0102030405060708, rejects files from the other endianness
+      16     8  word_size   sizeof(base_vector::__storage_type)
+      24     8  size        number of bases
+      32     *  words       ceil(size / bases_per_word) storage words, exactly as in base_vector;
+                            padding slots of the last word are zero
+
+The payload starts 32 bytes into the file, so a mapping of the whole file
+leaves it word aligned.
+
+namespace biovoltron
+{
+
+void save_packed(const base_vector& v, std::ostream& os);
+void save_packed(const base_vector& v, const std::string& path);
+
+class base_vector_view
+{
+ public:
+  typedef base_vector::value_type             value_type;
+  typedef base_vector::size_type              size_type;
+  typedef base_vector::difference_type        difference_type;
+  typedef base_vector::const_reference        reference;
+  typedef base_vector::const_reference        const_reference;
+  typedef base_vector::const_iterator         iterator;
+  typedef base_vector::const_iterator         const_iterator;
+  typedef base_vector::const_reverse_iterator reverse_iterator;
+  typedef base_vector::const_reverse_iterator const_reverse_iterator;
+
+  base_vector_view() noexcept;
+  explicit base_vector_view(const std::string& path);  // maps the file read-only
+  base_vector_view(base_vector_view&& v) noexcept;
+  base_vector_view& operator=(base_vector_view&& v) noexcept;
+  ~base_vector_view();
+
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_reverse_iterator rbegin() const noexcept;
+  const_reverse_iterator rend() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+  const_reverse_iterator crbegin() const noexcept;
+  const_reverse_iterator crend() const noexcept;
+
+  size_type size() const noexcept;
+  bool empty() const noexcept;
+
+  const_reference operator[](size_type n) const;
+  const_reference at(size_type n) const;
+  const_reference front() const;
+  const_reference back() const;
+  const base_vector::__storage_type* data() const noexcept;
+
+  size_type count(value_type x) const noexcept;
+  std::array<size_type, 4> histogram() const noexcept;
+
+  base_vector to_base_vector() const;
+  void swap(base_vector_view& v) noexcept;
+};
+
+void swap(base_vector_view& x, base_vector_view& y) noexcept;
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct __packed_header
+{
+  char          magic[8];
+  std::uint64_t byte_order;
+  std::uint64_t word_size;
+  std::uint64_t size;
+};
+
+inline constexpr char          __packed_magic[8]  = {'B', 'V', 'P', 'A', 'C', 'K', '\0', '\0'};
+inline constexpr std::uint64_t __packed_byte_order = 0x0102030405060708;
+
+void save_packed(const base_vector& v, std::ostream& os)
+{
+  typedef base_vector::__storage_type __storage_type;
+  __packed_header h;
+  std::memcpy(h.magic, __packed_magic, sizeof(h.magic));
+  h.byte_order = __packed_byte_order;
+  h.word_size = sizeof(__storage_type);
+  h.size = v.size();
+  os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+  const base_vector::size_type full = v.size() / base_vector::bases_per_word;
+  const unsigned rest = v.size() % base_vector::bases_per_word;
+  os.write(reinterpret_cast<const char*>(v.data()), full * sizeof(__storage_type));
+  if (rest != 0)
+  {
+    const __storage_type w = v.data()[full] & ~(~__storage_type(0) << (2 * rest));
+    os.write(reinterpret_cast<const char*>(&w), sizeof(w));
+  }
+}
+
+void save_packed(const base_vector& v, const std::string& path)
+{
+  std::ofstream os(path, std::ios::binary);
+  save_packed(v, os);
+  if (!os.flush())
+    throw std::runtime_error("save_packed: cannot write " + path);
+}
+
+//  A read-only base_vector over a file in the packed layout. The file is
+//  mapped, not read: opening costs one header check, pages come in as they
+//  are touched and are shared with every other process mapping the file.
+//  Iterators and references are those of a const base_vector.
+class base_vector_view
+{
+ public:
+  typedef base_vector::value_type             value_type;
+  typedef base_vector::size_type              size_type;
+  typedef base_vector::difference_type        difference_type;
+  typedef base_vector::const_reference        reference;
+  typedef base_vector::const_reference        const_reference;
+  typedef base_vector::const_iterator         iterator;
+  typedef base_vector::const_iterator         const_iterator;
+  typedef base_vector::const_reverse_iterator reverse_iterator;
+  typedef base_vector::const_reverse_iterator const_reverse_iterator;
+ private:
+  typedef base_vector::__storage_type __storage_type;
+
+  void*                 map_;
+  size_type             map_size_;
+  const __storage_type* begin_;
+  size_type             size_;
+
+  [[noreturn]] static void __throw_system_error(const std::string& what)
+  {throw std::system_error(errno, std::generic_category(), "base_vector_view: " + what);}
+  [[noreturn]] static void __throw_format_error(const std::string& path)
+  {throw std::runtime_error("base_vector_view: " + path + " is not a packed sequence file");}
+
+  const_iterator __make_iter(size_type pos) const noexcept
+  {return const_iterator(begin_ + pos / base_vector::bases_per_word, pos % base_vector::bases_per_word);}
+ public:
+  base_vector_view() noexcept : map_(nullptr), map_size_(0), begin_(nullptr), size_(0) {}
+  explicit base_vector_view(const std::string& path);
+  base_vector_view(const base_vector_view&) = delete;
+  base_vector_view& operator=(const base_vector_view&) = delete;
+
+  base_vector_view(base_vector_view&& v) noexcept : base_vector_view() {swap(v);}
+  base_vector_view& operator=(base_vector_view&& v) noexcept
+  {
+    base_vector_view(std::move(v)).swap(*this);
+    return *this;
+  }
+
+  ~base_vector_view()
+  {
+    if (map_ != nullptr)
+      ::munmap(map_, map_size_);
+  }
+
+  const_iterator begin() const noexcept {return __make_iter(0);}
+  const_iterator end() const noexcept {return __make_iter(size_);}
+  const_reverse_iterator rbegin() const noexcept {return const_reverse_iterator(end());}
+  const_reverse_iterator rend() const noexcept {return const_reverse_iterator(begin());}
+  const_iterator cbegin() const noexcept {return begin();}
+  const_iterator cend() const noexcept {return end();}
+  const_reverse_iterator crbegin() const noexcept {return rbegin();}
+  const_reverse_iterator crend() const noexcept {return rend();}
+
+  size_type size() const noexcept {return size_;}
+  bool empty() const noexcept {return size_ == 0;}
+
+  const_reference operator[](size_type n) const {return *__make_iter(n);}
+  const_reference at(size_type n) const
+  {
+    if (n >= size_)
+      throw std::out_of_range("base_vector_view");
+    return (*this)[n];
+  }
+  const_reference front() const {return *begin();}
+  const_reference back() const {return *__make_iter(size_ - 1);}
+  const __storage_type* data() const noexcept {return begin_;}
+
+  size_type count(value_type x) const noexcept {return biovoltron::count(begin(), end(), x);}
+  std::array<size_type, 4> histogram() const noexcept {return biovoltron::histogram(begin(), end());}
+
+  base_vector to_base_vector() const {return base_vector(begin(), end());}
+
+  void swap(base_vector_view& v) noexcept
+  {
+    std::swap(map_, v.map_);
+    std::swap(map_size_, v.map_size_);
+    std::swap(begin_, v.begin_);
+    std::swap(size_, v.size_);
+  }
+};
+
+base_vector_view::base_vector_view(const std::string& path) : base_vector_view()
+{
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    __throw_system_error("cannot open " + path);
+  struct stat st;
+  if (::fstat(fd, &st) == -1)
+  {
+    const int e = errno;
+    ::close(fd);
+    errno = e;
+    __throw_system_error("cannot stat " + path);
+  }
+  const size_type file_size = static_cast<size_type>(st.st_size);
+  if (file_size < sizeof(__packed_header))
+  {
+    ::close(fd);
+    __throw_format_error(path);
+  }
+  void* p = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  const int e = errno;
+  ::close(fd);
+  if (p == MAP_FAILED)
+  {
+    errno = e;
+    __throw_system_error("cannot map " + path);
+  }
+  map_ = p;
+  map_size_ = file_size;
+
+  // the delegated constructor has completed, so throwing here unmaps
+  const __packed_header& h = *static_cast<const __packed_header*>(p);
+  if (std::memcmp(h.magic, __packed_magic, sizeof(h.magic)) != 0 ||
+      h.byte_order != __packed_byte_order ||
+      h.word_size != sizeof(__storage_type) ||
+      h.size > (file_size - sizeof(h)) / sizeof(__storage_type) * base_vector::bases_per_word)
+    __throw_format_error(path);
+  begin_ = reinterpret_cast<const __storage_type*>(static_cast<const char*>(p) + sizeof(h));
+  size_ = h.size;
+}
+
+void swap(base_vector_view& x, base_vector_view& y) noexcept {x.swap(y);}
+
+}
+
+#endif //BIOVOLTRON_BASE_VECTOR_VIEW
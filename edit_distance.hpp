@@ -0,0 +1,301 @@
+#ifndef BIOVOLTRON_EDIT_DISTANCE
+#define BIOVOLTRON_EDIT_DISTANCE
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <vector>
+#include <algorithm>
+
+/*
+
+namespace biovoltron
+{
+
+struct edit_match
+{
+  std::size_t distance;
+  std::size_t end;       // one past the last text base of the best match
+};
+
+class myers_pattern
+{
+ public:
+  typedef std::size_t size_type;
+
+  static constexpr size_type npos = -1;
+
+  myers_pattern() noexcept;
+  template <class Container>  // base_vector, small_base_vector<N> or vector<uint2_t>
+  explicit myers_pattern(const Container& pattern);
+
+  size_type size() const noexcept;
+
+  // Levenshtein distance between the pattern and the whole text
+  size_type distance(std::ranges::input_range auto&& text) const;
+  // the same, or max + 1 as soon as it is known to exceed max
+  size_type distance(std::ranges::input_range auto&& text, size_type max) const;
+  // best distance between the pattern and any substring of the text;
+  // distance is max + 1 and end is npos when none is within max
+  edit_match search(std::ranges::input_range auto&& text) const;
+  edit_match search(std::ranges::input_range auto&& text, size_type max) const;
+};
+
+template <class Container>
+  std::size_t edit_distance(const Container& pattern, std::ranges::input_range auto&& text);
+template <class Container>
+  std::size_t edit_distance(const Container& pattern, std::ranges::input_range auto&& text, std::size_t max);
+template <class Container>
+  edit_match edit_search(const Container& pattern, std::ranges::input_range auto&& text);
+template <class Container>
+  edit_match edit_search(const Container& pattern, std::ranges::input_range auto&& text, std::size_t max);
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct edit_match
+{
+  std::size_t distance;
+  std::size_t end;
+
+  friend bool operator==(const edit_match&, const edit_match&) = default;
+};
+
+//  Myers' bit-vector algorithm in Hyyro's blocked form: the pattern is cut
+//  into 64-row blocks, each column of the dynamic programming matrix is
+//  two bit vectors of vertical deltas per block, and every text base
+//  advances them with a handful of word operations. The match masks are
+//  compacted straight from the packed pattern words. With a max distance
+//  only the blocks that can still hold a cell within max are advanced
+//  (Ukkonen's cutoff), which is what makes the bounded forms cheap.
+class myers_pattern
+{
+ public:
+  typedef std::size_t size_type;
+
+  static constexpr size_type npos = -1;
+
+ private:
+  typedef std::uint64_t __word;
+
+  static constexpr unsigned __rows = 64;
+
+  std::vector<__word> peq_;  // peq_[c * blocks_ + b]: rows of block b holding c
+  size_type size_ = 0;
+  size_type blocks_ = 0;
+
+  //  Gathers the even bits of w into its low half.
+  template <class StorageType>
+  static StorageType __compact(StorageType w) noexcept
+  {
+    constexpr unsigned bits_per_word = sizeof(StorageType) * CHAR_BIT;
+    for (unsigned s = 1; s < bits_per_word / 2; s <<= 1)
+    {
+      const StorageType m = ~StorageType(0) / ((StorageType(1) << (2 * s)) + 1);
+      w = (w | w >> s) & m;
+    }
+    return w;
+  }
+
+  size_type __height(size_type b) const noexcept
+  {return b + 1 != blocks_ ? __rows : size_ - b * __rows;}
+
+  //  Advances block b by one text column given the horizontal delta hin
+  //  entering its top row; returns the delta leaving its bottom row.
+  static int __advance(__word& pv, __word& mv, __word eq, int hin, unsigned bottom) noexcept
+  {
+    const __word xv = eq | mv;
+    if (hin < 0)
+      eq |= 1;
+    const __word xh = (((eq & pv) + pv) ^ pv) | eq;
+    __word ph = mv | ~(xh | pv);
+    __word mh = pv & xh;
+    const int hout = (ph >> bottom & 1) ? 1 : (mh >> bottom & 1) ? -1 : 0;
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0)
+      mh |= 1;
+    else if (hin > 0)
+      ph |= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+  }
+
+  //  Runs the text through the blocks. Global alignment charges the top
+  //  row for every text base, semi-global lets the match start anywhere.
+  //  Returns the best bottom-row score seen (global: the last one) and the
+  //  column it was seen at, or k + 1 and npos when none was within k.
+  template <class Range>
+  edit_match __run(Range&& text, bool global, size_type k, __word* pv, __word* mv, size_type* score) const
+  {
+    std::fill(pv, pv + blocks_, ~__word(0));
+    std::fill(mv, mv + blocks_, __word(0));
+    for (size_type b = 0; b != blocks_; ++b)
+      score[b] = b * __rows + __height(b);
+
+    // blocks past last hold no cell within k
+    const size_type top = std::min(blocks_, k / __rows + 1);
+    std::ptrdiff_t last = static_cast<std::ptrdiff_t>(top) - 1;
+    edit_match best{k + 1, npos};
+    if (size_ <= k)
+      best = {size_, 0};
+    size_type j = 0;
+    for (auto&& x : text)
+    {
+      ++j;
+      const unsigned char c = x;
+      const __word* eq = peq_.data() + c * blocks_;
+      int hout = global ? 1 : 0;
+      for (std::ptrdiff_t b = 0; b <= last; ++b)
+      {
+        hout = __advance(pv[b], mv[b], eq[b], hout, static_cast<unsigned>(__height(b) - 1));
+        score[b] += hout;
+      }
+      if (last + 1 < static_cast<std::ptrdiff_t>(blocks_) && last >= 0
+          && score[last] - hout <= k && ((eq[last + 1] & 1) || hout < 0))
+      {
+        ++last;
+        pv[last] = ~__word(0);
+        mv[last] = 0;
+        // the new block starts from the previous column, one more per row
+        score[last] = score[last - 1] - hout + __height(last);
+        hout = __advance(pv[last], mv[last], eq[last], hout, static_cast<unsigned>(__height(last) - 1));
+        score[last] += hout;
+      }
+      while (last >= 0 && score[last] >= k + __rows)
+        --last;
+      if (last < 0)
+      {
+        if (global)
+          return {k + 1, npos};
+        // semi-global drops every block only for k == 0 with row i
+        // holding i all through the first block, which is its start state
+        last = 0;
+        pv[0] = ~__word(0);
+        mv[0] = 0;
+        score[0] = __height(0);
+      }
+      if (last + 1 == static_cast<std::ptrdiff_t>(blocks_) && score[last] <= k
+          && (global || score[last] < best.distance))
+        best = {score[last], j};
+    }
+    if (global && best.end != j)
+      return {k + 1, npos};
+    return best;
+  }
+
+  //  Short patterns keep their column on the stack.
+  template <class Range>
+  edit_match __run(Range&& text, bool global, size_type k) const
+  {
+    constexpr size_type small = 4;
+    if (blocks_ <= small)
+    {
+      __word pv[small], mv[small];
+      size_type score[small];
+      return __run(text, global, k, pv, mv, score);
+    }
+    std::vector<__word> pv(blocks_), mv(blocks_);
+    std::vector<size_type> score(blocks_);
+    return __run(text, global, k, pv.data(), mv.data(), score.data());
+  }
+
+  template <class Range>
+  static size_type __length(Range&& text)
+  {
+    if constexpr (std::ranges::sized_range<Range>)
+      return std::ranges::size(text);
+    else
+      return npos;
+  }
+
+ public:
+  myers_pattern() noexcept = default;
+
+  template <class Container>
+  explicit myers_pattern(const Container& pattern)
+    : size_(pattern.size()), blocks_((pattern.size() + __rows - 1) / __rows)
+  {
+    typedef std::remove_cvref_t<decltype(*std::to_address(pattern.data()))> __storage_type;
+    constexpr unsigned bases_per_word = sizeof(__storage_type) * CHAR_BIT / 2;
+    static_assert(__rows % bases_per_word == 0, "storage words must tile a block");
+    const __storage_type* w = std::to_address(pattern.data());
+    const __storage_type lo = ~__storage_type(0) / 3;
+    const size_type nw = (size_ + bases_per_word - 1) / bases_per_word;
+    peq_.assign(4 * blocks_, 0);
+    for (size_type i = 0; i != nw; ++i)
+    {
+      const size_type valid = std::min<size_type>(bases_per_word, size_ - i * bases_per_word);
+      const __word keep = (__word(1) << valid) - 1;
+      const unsigned shift = i * bases_per_word % __rows;
+      for (unsigned c = 0; c != 4; ++c)
+      {
+        const __storage_type x = w[i] ^ (lo * c);
+        const __word m = static_cast<__word>(__compact<__storage_type>(~(x | x >> 1) & lo)) & keep;
+        peq_[c * blocks_ + i * bases_per_word / __rows] |= m << shift;
+      }
+    }
+  }
+
+  size_type size() const noexcept {return size_;}
+
+  size_type distance(std::ranges::input_range auto&& text) const
+  {return distance(text, std::numeric_limits<size_type>::max());}
+
+  size_type distance(std::ranges::input_range auto&& text, size_type max) const
+  {
+    const size_type n = __length(text);
+    if (n != npos && (n > size_ ? n - size_ : size_ - n) > max)
+      return max + 1;
+    if (size_ == 0)
+    {
+      size_type j = 0;
+      for (auto it = std::ranges::begin(text); it != std::ranges::end(text) && j <= max; ++it)
+        ++j;
+      return j;
+    }
+    // no distance exceeds the longer length, so a larger max changes nothing
+    const size_type k = n != npos ? std::min(max, std::max(n, size_)) : std::min(max, npos - 2 * __rows);
+    const edit_match r = __run(text, true, k);
+    return r.end == npos ? max + 1 : r.distance;
+  }
+
+  edit_match search(std::ranges::input_range auto&& text) const
+  {return search(text, std::numeric_limits<size_type>::max());}
+
+  edit_match search(std::ranges::input_range auto&& text, size_type max) const
+  {
+    if (size_ == 0)
+      return {0, 0};
+    const edit_match r = __run(text, false, std::min(max, size_));
+    return r.end == npos ? edit_match{max + 1, npos} : r;
+  }
+};
+
+template <class Container>
+inline std::size_t edit_distance(const Container& pattern, std::ranges::input_range auto&& text)
+{return myers_pattern(pattern).distance(text);}
+
+template <class Container>
+inline std::size_t edit_distance(const Container& pattern, std::ranges::input_range auto&& text, std::size_t max)
+{return myers_pattern(pattern).distance(text, max);}
+
+template <class Container>
+inline edit_match edit_search(const Container& pattern, std::ranges::input_range auto&& text)
+{return myers_pattern(pattern).search(text);}
+
+template <class Container>
+inline edit_match edit_search(const Container& pattern, std::ranges::input_range auto&& text, std::size_t max)
+{return myers_pattern(pattern).search(text, max);}
+
+}
+
+#endif //BIOVOLTRON_EDIT_DISTANCE
@@ -0,0 +1,203 @@
+#ifndef BIOVOLTRON_FM_INDEX
+#define BIOVOLTRON_FM_INDEX
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <array>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+#include "base_vector.hpp"
+#include "rank_select.hpp"
+#include "suffix_array.hpp"
+
+/*
+
+The Burrows-Wheeler transform of text$ where $ sorts before every base.
+Row r of the BWT is the base before the r-th smallest suffix of text$;
+the one row whose suffix is the whole text holds $ and is left out of the
+packed BWT, its position is returned as the primary row.
+
+namespace biovoltron
+{
+
+template <class Container>  // base_vector, small_base_vector<N> or vector<uint2_t>
+  std::pair<base_vector, std::size_t> bwt(const Container& text);
+template <class Container, class Index>  // Index as given to suffix_array
+  std::pair<base_vector, std::size_t> bwt(const Container& text, const std::vector<Index>& sa);
+
+class fm_index
+{
+ public:
+  typedef std::size_t size_type;
+
+  static constexpr size_type default_sa_sample_rate = 32;
+
+  fm_index() noexcept;
+  template <class Container>
+  explicit fm_index(const Container& text, size_type sa_sample_rate = default_sa_sample_rate);
+
+  size_type size() const noexcept;             // length of the text; the BWT has size() + 1 rows
+  size_type primary() const noexcept;          // row holding $
+  size_type sa_sample_rate() const noexcept;
+  const rank_select& occ() const noexcept;     // the BWT without $, with rank support
+
+  size_type lf(size_type row) const noexcept;  // row of the suffix one base longer
+                                               // Precondition:  row != primary()
+  size_type locate(size_type row) const noexcept;  // suffix array entry of row
+
+  std::pair<size_type, size_type> range(std::ranges::bidirectional_range auto&& pattern) const;  // rows [first, second)
+  size_type count(std::ranges::bidirectional_range auto&& pattern) const;
+  std::vector<size_type> locate(std::ranges::bidirectional_range auto&& pattern) const;  // in row order
+};
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+template <class Container, class Index>
+std::pair<base_vector, std::size_t> bwt(const Container& text, const std::vector<Index>& sa)
+{
+  const std::size_t n = text.size();
+  std::pair<base_vector, std::size_t> r(base_vector(), 0);
+  r.first.reserve(n);
+  if (n != 0)
+    r.first.push_back(text[n - 1]);  // row 0 is the suffix $
+  for (std::size_t j = 0; j != n; ++j)
+  {
+    if (sa[j] == 0)
+      r.second = j + 1;
+    else
+      r.first.push_back(text[sa[j] - 1]);
+  }
+  return r;
+}
+
+template <class Container>
+std::pair<base_vector, std::size_t> bwt(const Container& text)
+{
+  if (text.size() < std::numeric_limits<std::uint32_t>::max())
+    return bwt(text, suffix_array<std::uint32_t>(text));
+  return bwt(text, suffix_array(text));
+}
+
+//  Backward search over the packed BWT inside a rank_select, about 2.29
+//  bits per base with its counts, so each step reads one cache line per end
+//  of the range. Every sa_sample_rate-th row keeps its 64-bit suffix array
+//  entry, another 64 / sa_sample_rate bits per base (2 at the default);
+//  locate walks LF from any other row until it reaches a sampled one.
+//  Construction holds a 32-bit suffix array for texts under 2^32 bases.
+class fm_index
+{
+ public:
+  typedef std::size_t size_type;
+
+  static constexpr size_type default_sa_sample_rate = 32;
+
+  fm_index() noexcept = default;
+
+  template <class Container>
+  explicit fm_index(const Container& text, size_type sa_sample_rate = default_sa_sample_rate)
+    : size_(text.size()), rate_(sa_sample_rate)
+  {
+    if (rate_ == 0)
+      throw std::invalid_argument("fm_index: sa_sample_rate must be positive");
+    if (size_ < std::numeric_limits<std::uint32_t>::max())
+      __build(text, suffix_array<std::uint32_t>(text));
+    else
+      __build(text, suffix_array(text));
+  }
+
+  size_type size() const noexcept {return size_;}
+  size_type primary() const noexcept {return primary_;}
+  size_type sa_sample_rate() const noexcept {return rate_;}
+  const rank_select& occ() const noexcept {return occ_;}
+
+  size_type lf(size_type row) const noexcept
+  {
+    const size_type i = row < primary_ ? row : row - 1;
+    const unsigned char c = occ_[i];
+    return c_[c] + occ_.rank(c, i);
+  }
+
+  size_type locate(size_type row) const noexcept
+  {
+    size_type steps = 0;
+    for (; row % rate_ != 0; ++steps)
+    {
+      if (row == primary_)
+        return steps;
+      row = lf(row);
+    }
+    return samples_[row / rate_] + steps;
+  }
+
+  std::pair<size_type, size_type> range(std::ranges::bidirectional_range auto&& pattern) const
+  {
+    size_type lo = 0, hi = size_ + 1;
+    auto first = std::ranges::begin(pattern);
+    auto it = std::ranges::next(first, std::ranges::end(pattern));
+    while (it != first && lo < hi)
+    {
+      const unsigned char c = *--it;
+      lo = c_[c] + __occ(c, lo);
+      hi = c_[c] + __occ(c, hi);
+    }
+    return lo < hi ? std::pair(lo, hi) : std::pair(lo, lo);
+  }
+
+  size_type count(std::ranges::bidirectional_range auto&& pattern) const
+  {
+    auto [lo, hi] = range(pattern);
+    return hi - lo;
+  }
+
+  std::vector<size_type> locate(std::ranges::bidirectional_range auto&& pattern) const
+  {
+    auto [lo, hi] = range(pattern);
+    std::vector<size_type> r;
+    r.reserve(hi - lo);
+    for (; lo != hi; ++lo)
+      r.push_back(locate(lo));
+    return r;
+  }
+
+ private:
+  rank_select               occ_;
+  std::array<size_type, 4>  c_{};      // first row of the suffixes starting with each base
+  std::vector<size_type>    samples_;  // suffix array at rows 0, rate_, 2 * rate_, ...
+  size_type                 size_ = 0;
+  size_type                 primary_ = 0;
+  size_type                 rate_ = default_sa_sample_rate;
+
+  template <class Container, class Index>
+  void __build(const Container& text, const std::vector<Index>& sa)
+  {
+    {
+      auto b = bwt(text, sa);
+      occ_ = rank_select(b.first);
+      primary_ = b.second;
+    }
+    c_[0] = 1;
+    for (unsigned x = 0; x != 3; ++x)
+      c_[x + 1] = c_[x] + occ_.count(x);
+    samples_.reserve(size_ / rate_ + 1);
+    samples_.push_back(size_);  // row 0, the suffix $
+    for (size_type r = rate_; r <= size_; r += rate_)
+      samples_.push_back(sa[r - 1]);
+  }
+
+  //  Occurrences of c in rows [0, row) of the BWT; $ is never counted.
+  size_type __occ(unsigned char c, size_type row) const noexcept
+  {return occ_.rank(c, row <= primary_ ? row : row - 1);}
+};
+
+}
+
+#endif //BIOVOLTRON_FM_INDEX
@@ -0,0 +1,131 @@
+#ifndef BIOVOLTRON_HAMMING
+#define BIOVOLTRON_HAMMING
+
+#include <cstddef>
+#include <bit>
+#include <limits>
+#include <vector>
+#include <stdexcept>
+#include "base_vector.hpp"
+#include "base_vector_set.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+template <class Cp, bool IC1, bool IC2>
+  typename Cp::size_type
+  hamming(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2);
+template <class Cp, bool IC1, bool IC2>
+  bool hamming_within(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2,
+                      typename Cp::size_type max);   // stops once more than max bases differ
+
+template <class Container>  // base_vector or small_base_vector<N>; sizes must be equal
+  typename Container::size_type hamming(const Container& x, const Container& y);
+template <class Container>
+  bool hamming_within(const Container& x, const Container& y, typename Container::size_type max);
+
+// one query against every sequence of a set
+std::vector<std::size_t> hamming(const base_vector_set& s, const base_vector& query);  // npos where lengths differ
+std::vector<std::size_t> hamming_within(const base_vector_set& s, const base_vector& query,
+                                        std::size_t max);  // indices of the sequences within max
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+//  Counts the positions where n bases differ, a word at a time: the xor of
+//  two words has a nonzero slot for every mismatch, folding each slot onto
+//  its low bit leaves one set bit per mismatch to popcount. Stops as soon
+//  as the count passes limit, so the result is only exact up to limit + 1.
+template <class Cp, bool IC1, bool IC2>
+typename Cp::size_type __hamming(base_iterator<Cp, IC1> first1, typename Cp::size_type n,
+                                 base_iterator<Cp, IC2> first2, typename Cp::size_type limit)
+{
+  typedef base_iterator<Cp, IC1>      It;
+  typedef typename Cp::size_type      size_type;
+  typedef typename It::__storage_type __storage_type;
+  const unsigned bits_per_word = It::bits_per_word;
+  const __storage_type lo_bits = ~__storage_type(0) / 3;
+  const unsigned ctz1 = first1.pos_ * 2;
+  const unsigned ctz2 = first2.pos_ * 2;
+  size_type r = 0;
+  n *= 2;
+  for (; n >= bits_per_word; n -= bits_per_word, ++first1.seg_, ++first2.seg_)
+  {
+    const __storage_type d = __load_word<__storage_type>(first1.seg_, ctz1, bits_per_word)
+                           ^ __load_word<__storage_type>(first2.seg_, ctz2, bits_per_word);
+    r += std::popcount((d | d >> 1) & lo_bits);
+    if (r > limit)
+      return r;
+  }
+  if (n > 0)
+  {
+    const auto nb = static_cast<unsigned>(n);
+    const __storage_type d = __load_word<__storage_type>(first1.seg_, ctz1, nb)
+                           ^ __load_word<__storage_type>(first2.seg_, ctz2, nb);
+    r += std::popcount((d | d >> 1) & lo_bits);
+  }
+  return r;
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline typename Cp::size_type
+hamming(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2)
+{
+  typedef typename Cp::size_type size_type;
+  return __hamming(first1, static_cast<size_type>(last1 - first1), first2, std::numeric_limits<size_type>::max());
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline bool hamming_within(base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1, base_iterator<Cp, IC2> first2,
+                           typename Cp::size_type max)
+{return __hamming(first1, static_cast<typename Cp::size_type>(last1 - first1), first2, max) <= max;}
+
+template <class Container>
+typename Container::size_type hamming(const Container& x, const Container& y)
+{
+  if (x.size() != y.size())
+    throw std::invalid_argument("hamming: sequences differ in length");
+  return hamming(x.begin(), x.end(), y.begin());
+}
+
+template <class Container>
+bool hamming_within(const Container& x, const Container& y, typename Container::size_type max)
+{
+  if (x.size() != y.size())
+    throw std::invalid_argument("hamming_within: sequences differ in length");
+  return hamming_within(x.begin(), x.end(), y.begin(), max);
+}
+
+//  The set keeps its sequences back to back, so the scan streams through
+//  one buffer; only the word loads differ from the pairwise form.
+std::vector<std::size_t> hamming(const base_vector_set& s, const base_vector& query)
+{
+  std::vector<std::size_t> r(s.size(), static_cast<std::size_t>(-1));
+  const auto& off = s.offsets();
+  const auto first = s.bases().begin();
+  for (std::size_t i = 0; i != s.size(); ++i)
+    if (off[i + 1] - off[i] == query.size())
+      r[i] = __hamming(first + off[i], query.size(), query.begin(), std::numeric_limits<std::size_t>::max());
+  return r;
+}
+
+std::vector<std::size_t> hamming_within(const base_vector_set& s, const base_vector& query, std::size_t max)
+{
+  std::vector<std::size_t> r;
+  const auto& off = s.offsets();
+  const auto first = s.bases().begin();
+  for (std::size_t i = 0; i != s.size(); ++i)
+    if (off[i + 1] - off[i] == query.size() && __hamming(first + off[i], query.size(), query.begin(), max) <= max)
+      r.push_back(i);
+  return r;
+}
+
+}
+
+#endif //BIOVOLTRON_HAMMING
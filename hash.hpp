@@ -0,0 +1,146 @@
+#ifndef BIOVOLTRON_HASH
+#define BIOVOLTRON_HASH
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "uint2_t.hpp"
+#include "base_vector.hpp"
+#include "base_span.hpp"
+
+/*
+
+Hashes of packed sequences computed from their storage words, 32 bases per
+multiply instead of one byte per base of a decoded string. A sequence is
+hashed as the words it would occupy starting at a word boundary, with the
+unused slots of the last word cleared, so a span at any offset hashes like
+a container holding the same bases. The hashes are transparent: with
+std::equal_to<> as the key equality, an unordered container of sequences
+can be searched with a span without building a key.
+
+namespace std
+{
+
+template <> struct hash<biovoltron::base_vector>;        // also takes const_base_span
+template <> struct hash<vector<uint2_t>>;                // also takes const_uint2_span
+template <class Iterator> struct hash<biovoltron::packed_span<Iterator>>;
+
+}  // std
+
+*/
+
+namespace biovoltron
+{
+
+//  wyhash's multiply-fold mix: the two halves of the 128-bit product
+//  xored together.
+inline std::uint64_t __wymix(std::uint64_t a, std::uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+#else
+  const std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+  const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const std::uint64_t t = rl + (rm0 << 32), c = t < rl;
+  const std::uint64_t lo = t + (rm1 << 32);
+  const std::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c + (lo < t);
+  return lo ^ hi;
+#endif
+}
+
+inline constexpr std::uint64_t __wyp[4] =
+  {0xa0761d6478bd642f, 0xe7037ed1a0b428db, 0x8ebc6af09c88c6e3, 0x589965cc75374cc3};
+
+//  Feeds the words of a sequence of n elements, as produced by load(i),
+//  through the mix two at a time, then folds in the length.
+template <class Load>
+inline std::size_t __hash_words(Load load, std::size_t words, std::size_t n) noexcept
+{
+  std::uint64_t h = __wymix(n ^ __wyp[0], __wyp[1]);
+  std::size_t i = 0;
+  for (; i + 2 <= words; i += 2)
+    h ^= __wymix(load(i) ^ __wyp[1], load(i + 1) ^ h ^ __wyp[2]);
+  if (i != words)
+    h ^= __wymix(load(i) ^ __wyp[1], h ^ __wyp[3]);
+  return static_cast<std::size_t>(__wymix(h ^ __wyp[0], n ^ __wyp[3]));
+}
+
+template <class Cp, bool IsConst>
+std::size_t __hash(base_iterator<Cp, IsConst> first, typename Cp::size_type n) noexcept
+{
+  typedef base_iterator<Cp, IsConst>  It;
+  typedef typename It::__storage_type __storage_type;
+  static_assert(sizeof(__storage_type) == sizeof(std::uint64_t), "hash mixes 64-bit words");
+  const unsigned bases_per_word = It::bases_per_word;
+  const unsigned ctz = first.pos_ * 2;
+  const std::size_t words = (n + bases_per_word - 1) / bases_per_word;
+  return __hash_words([&](std::size_t i) -> std::uint64_t
+  {
+    const std::size_t rest = n - i * bases_per_word;
+    const unsigned nb = rest < bases_per_word ? static_cast<unsigned>(rest * 2) : It::bits_per_word;
+    return __load_word<__storage_type>(first.seg_ + i, ctz, nb);
+  }, words, n);
+}
+
+}
+
+namespace detail
+{
+
+template <class Cp, bool IsConst>
+std::size_t __hash(__uint2_iterator<Cp, IsConst> first, typename Cp::size_type n) noexcept
+{
+    typedef __uint2_iterator<Cp, IsConst> It;
+    typedef typename It::__storage_type   __storage_type;
+    static_assert(sizeof(__storage_type) == sizeof(std::uint64_t), "hash mixes 64-bit words");
+    const unsigned uint2_per_word = It::uint2_per_word;
+    const unsigned ctz = first.pos_ * 2;
+    const std::size_t words = (n + uint2_per_word - 1) / uint2_per_word;
+    return biovoltron::__hash_words([&](std::size_t i) -> std::uint64_t
+    {
+        const std::size_t rest = n - i * uint2_per_word;
+        const unsigned nb = rest < uint2_per_word ? static_cast<unsigned>(rest * 2) : It::bits_per_word;
+        return __load_word<__storage_type>(first.seg_ + i, ctz, nb);
+    }, words, n);
+}
+
+}
+
+template <>
+struct std::hash<biovoltron::base_vector>
+{
+  typedef void is_transparent;
+
+  std::size_t operator()(const biovoltron::base_vector& v) const noexcept
+  {return biovoltron::__hash(v.begin(), v.size());}
+  std::size_t operator()(biovoltron::const_base_span s) const noexcept
+  {return biovoltron::__hash(s.begin(), s.size());}
+};
+
+template <>
+struct std::hash<std::vector<std::uint2_t>>
+{
+  typedef void is_transparent;
+
+  std::size_t operator()(const std::vector<std::uint2_t>& v) const noexcept
+  {return detail::__hash(v.begin(), v.size());}
+  std::size_t operator()(biovoltron::const_uint2_span s) const noexcept
+  {return detail::__hash(s.begin(), s.size());}
+};
+
+template <class Iterator>
+struct std::hash<biovoltron::packed_span<Iterator>>
+{
+  typedef void is_transparent;
+
+  std::size_t operator()(biovoltron::packed_span<Iterator> s) const noexcept
+  {
+    using biovoltron::__hash;
+    using detail::__hash;
+    return __hash(s.begin(), s.size());
+  }
+};
+
+#endif //BIOVOLTRON_HASH
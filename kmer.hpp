@@ -0,0 +1,175 @@
+#ifndef BIOVOLTRON_KMER
+#define BIOVOLTRON_KMER
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <iterator>
+#include <memory>
+#include <algorithm>
+
+/*
+
+namespace biovoltron
+{
+
+struct kmer
+{
+  std::uint64_t forward;   // first base in the most significant slot
+  std::uint64_t reverse;   // code of the reverse complement
+  std::size_t   position;  // offset of the first base
+
+  std::uint64_t canonical() const noexcept;
+  bool is_reverse() const noexcept;
+};
+
+template <unsigned K>  // 0 < K <= 32
+class kmer_range
+{
+ public:
+  typedef std::uint64_t          code_type;
+  typedef std::size_t            size_type;
+  typedef implementation-defined iterator;
+  typedef iterator               const_iterator;
+
+  static constexpr code_type mask;
+
+  template <class Container>  // base_vector or vector<uint2_t>
+  explicit kmer_range(const Container& c) noexcept;
+  template <class Container>
+  kmer_range(const Container& c, size_type pos, size_type n) noexcept;
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+  size_type size() const noexcept;
+  bool empty() const noexcept;
+};
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct kmer
+{
+  std::uint64_t forward;
+  std::uint64_t reverse;
+  std::size_t   position;
+
+  std::uint64_t canonical() const noexcept {return std::min(forward, reverse);}
+  bool is_reverse() const noexcept {return reverse < forward;}
+
+  friend bool operator==(const kmer&, const kmer&) = default;
+};
+
+//  Yields every k-mer of a packed sequence in order. Each step reads the
+//  next base straight from the storage word and rolls both codes in O(1).
+template <unsigned K>
+class kmer_range
+{
+  static_assert(K > 0 && K <= 32, "a k-mer code must fit in 64 bits");
+ public:
+  typedef std::uint64_t code_type;
+  typedef std::size_t   size_type;
+
+  static constexpr code_type mask = ~code_type(0) >> (64 - 2 * K);
+
+  class iterator
+  {
+   public:
+    typedef std::ptrdiff_t            difference_type;
+    typedef kmer                      value_type;
+    typedef const kmer*               pointer;
+    typedef const kmer&               reference;
+    typedef std::forward_iterator_tag iterator_category;
+
+    iterator() noexcept : seg_(nullptr), shift_(0), kmer_{0, 0, 0} {}
+
+    reference operator*() const noexcept {return kmer_;}
+    pointer operator->() const noexcept {return &kmer_;}
+
+    iterator& operator++() noexcept
+    {
+      if (++kmer_.position != last_)
+        __push();
+      return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const iterator& x, const iterator& y) noexcept
+    {return x.kmer_.position == y.kmer_.position;}
+    friend bool operator!=(const iterator& x, const iterator& y) noexcept {return !(x == y);}
+
+   private:
+    static constexpr unsigned bits_per_word = sizeof(size_type) * CHAR_BIT;
+
+    const size_type* seg_;
+    unsigned shift_;
+    size_type last_;
+    kmer kmer_;
+
+    //  Positions on the k-mer starting at first and primes the codes.
+    //  Precondition:  first < last
+    iterator(const size_type* seg, size_type first, size_type last) noexcept
+      : seg_(seg + first * 2 / bits_per_word),
+        shift_(static_cast<unsigned>(first * 2 % bits_per_word)),
+        last_(last),
+        kmer_{0, 0, 0}
+    {
+      for (unsigned i = 0; i != K; ++i)
+        __push();
+      kmer_.position = first;
+    }
+
+    iterator(size_type last) noexcept : seg_(nullptr), shift_(0), last_(last), kmer_{0, 0, last} {}
+
+    void __push() noexcept
+    {
+      code_type b = *seg_ >> shift_ & 3;
+      shift_ += 2;
+      if (shift_ == bits_per_word)
+      {
+        shift_ = 0;
+        ++seg_;
+      }
+      kmer_.forward = (kmer_.forward << 2 | b) & mask;
+      kmer_.reverse = kmer_.reverse >> 2 | (3 ^ b) << (2 * (K - 1));
+    }
+
+    friend class kmer_range;
+  };
+  typedef iterator const_iterator;
+
+  template <class Container>
+  explicit kmer_range(const Container& c) noexcept : kmer_range(c, 0, c.size()) {}
+
+  template <class Container>
+  kmer_range(const Container& c, size_type pos, size_type n) noexcept
+    : seg_(std::to_address(c.data())),
+      first_(pos),
+      last_(n < K ? pos : pos + n - K + 1)
+  {}
+
+  iterator begin() const noexcept {return first_ == last_ ? end() : iterator(seg_, first_, last_);}
+  iterator end() const noexcept {return iterator(last_);}
+
+  size_type size() const noexcept {return last_ - first_;}
+  bool empty() const noexcept {return first_ == last_;}
+
+ private:
+  const size_type* seg_;
+  size_type first_;
+  size_type last_;
+};
+
+}
+
+#endif //BIOVOLTRON_KMER
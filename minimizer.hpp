@@ -0,0 +1,378 @@
+#ifndef BIOVOLTRON_MINIMIZER
+#define BIOVOLTRON_MINIMIZER
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <limits>
+#include <iterator>
+#include "kmer.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+struct seed
+{
+  std::uint64_t hash;      // hash of the canonical k-mer code
+  std::size_t   position;  // offset of the first base of the k-mer
+  bool          reverse;   // canonical code came from the reverse strand
+};
+
+struct invertible_hash
+{
+  std::uint64_t operator()(std::uint64_t key, std::uint64_t mask) const noexcept;
+  std::uint64_t inverse(std::uint64_t key, std::uint64_t mask) const noexcept;
+};
+
+template <unsigned K, unsigned W, class Hash = invertible_hash>
+class minimizer_range
+{
+ public:
+  typedef std::size_t            size_type;
+  typedef implementation-defined iterator;
+  typedef iterator               const_iterator;
+
+  template <class Container>  // base_vector or vector<uint2_t>
+  explicit minimizer_range(const Container& c, Hash hash = Hash()) noexcept;
+  template <class Container>
+  minimizer_range(const Container& c, size_type pos, size_type n, Hash hash = Hash()) noexcept;
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+};
+
+enum class syncmer_type { open, closed };
+
+template <unsigned K, unsigned S, class Hash = invertible_hash>
+class syncmer_range
+{
+ public:
+  typedef std::size_t            size_type;
+  typedef implementation-defined iterator;
+  typedef iterator               const_iterator;
+
+  template <class Container>
+  explicit syncmer_range(const Container& c, syncmer_type type = syncmer_type::closed,
+                         unsigned offset = 0, Hash hash = Hash()) noexcept;
+  template <class Container>
+  syncmer_range(const Container& c, size_type pos, size_type n, syncmer_type type = syncmer_type::closed,
+                unsigned offset = 0, Hash hash = Hash()) noexcept;
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+};
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct seed
+{
+  std::uint64_t hash;
+  std::size_t   position;
+  bool          reverse;
+
+  friend bool operator==(const seed&, const seed&) = default;
+};
+
+//  Thomas Wang's 64-bit integer hash restricted to the bits of mask, so that
+//  it is a bijection on the codes of one k and can be inverted back to the
+//  k-mer.
+struct invertible_hash
+{
+  std::uint64_t operator()(std::uint64_t key, std::uint64_t mask) const noexcept
+  {
+    key = (~key + (key << 21)) & mask;
+    key = key ^ key >> 24;
+    key = ((key + (key << 3)) + (key << 8)) & mask;
+    key = key ^ key >> 14;
+    key = ((key + (key << 2)) + (key << 4)) & mask;
+    key = key ^ key >> 28;
+    key = (key + (key << 31)) & mask;
+    return key;
+  }
+
+  std::uint64_t inverse(std::uint64_t key, std::uint64_t mask) const noexcept
+  {
+    std::uint64_t tmp;
+    // invert key = key + (key << 31)
+    tmp = key - (key << 31);
+    key = (key - (tmp << 31)) & mask;
+    // invert key = key ^ key >> 28
+    tmp = key ^ key >> 28;
+    key = key ^ tmp >> 28;
+    // invert key *= 21
+    key = (key * 14933078535860113213ull) & mask;
+    // invert key = key ^ key >> 14
+    tmp = key ^ key >> 14;
+    tmp = key ^ tmp >> 14;
+    tmp = key ^ tmp >> 14;
+    key = key ^ tmp >> 14;
+    // invert key *= 265
+    key = (key * 15244667743933553977ull) & mask;
+    // invert key = key ^ key >> 24
+    tmp = key ^ key >> 24;
+    key = key ^ tmp >> 24;
+    // invert key = ~key + (key << 21)
+    tmp = ~key;
+    tmp = ~(key - (tmp << 21));
+    tmp = ~(key - (tmp << 21));
+    key = ~(key - (tmp << 21)) & mask;
+    return key;
+  }
+};
+
+//  Sliding window minimum over at most N consecutive positions, kept as a
+//  monotone deque in a fixed ring buffer. Among equal hashes the leftmost
+//  one stays in front.
+template <std::size_t N>
+class __seed_window
+{
+  std::array<seed, N> buf_;
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+ public:
+  const seed& front() const noexcept {return buf_[head_];}
+  bool empty() const noexcept {return size_ == 0;}
+
+  //  Drops the seeds that fall out of a window ending at pos.
+  void slide(std::size_t pos) noexcept
+  {
+    for (; size_ != 0 && front().position + N <= pos; --size_)
+      head_ = (head_ + 1) % N;
+  }
+
+  void push(const seed& s) noexcept
+  {
+    while (size_ != 0 && buf_[(head_ + size_ - 1) % N].hash > s.hash)
+      --size_;
+    buf_[(head_ + size_++) % N] = s;
+  }
+};
+
+//  Yields the (w,k)-minimizers of a packed sequence: for every window of W
+//  consecutive k-mers the one with the smallest hash of its canonical code,
+//  each distinct seed once. A sequence with fewer than W k-mers yields the
+//  minimum of what it has.
+template <unsigned K, unsigned W, class Hash = invertible_hash>
+class minimizer_range
+{
+  static_assert(W > 0, "a window holds at least one k-mer");
+  typedef typename kmer_range<K>::iterator __kmer_iterator;
+ public:
+  typedef std::size_t size_type;
+
+  class iterator
+  {
+   public:
+    typedef std::ptrdiff_t            difference_type;
+    typedef seed                      value_type;
+    typedef const seed*               pointer;
+    typedef const seed&               reference;
+    typedef std::forward_iterator_tag iterator_category;
+
+    iterator() noexcept : cur_{0, npos, false}, count_(0), done_(true) {}
+
+    reference operator*() const noexcept {return cur_;}
+    pointer operator->() const noexcept {return &cur_;}
+
+    iterator& operator++() noexcept
+    {
+      __next();
+      return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const iterator& x, const iterator& y) noexcept
+    {return x.done_ == y.done_ && (x.done_ || x.cur_.position == y.cur_.position);}
+    friend bool operator!=(const iterator& x, const iterator& y) noexcept {return !(x == y);}
+
+   private:
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    __kmer_iterator it_;
+    __kmer_iterator last_;
+    Hash hash_;
+    __seed_window<W> win_;
+    seed cur_;
+    size_type count_;
+    bool done_;
+
+    iterator(__kmer_iterator first, __kmer_iterator last, const Hash& hash) noexcept
+      : it_(first), last_(last), hash_(hash), cur_{0, npos, false}, count_(0), done_(false)
+    {__next();}
+
+    void __next() noexcept
+    {
+      for (; it_ != last_; ++it_)
+      {
+        const kmer& km = *it_;
+        win_.slide(km.position);
+        win_.push({hash_(km.canonical(), kmer_range<K>::mask), km.position, km.is_reverse()});
+        if (++count_ >= W && win_.front().position != cur_.position)
+        {
+          cur_ = win_.front();
+          ++it_;
+          return;
+        }
+      }
+      // a short sequence never fills a window, report its minimum once
+      if (count_ != 0 && count_ < W)
+      {
+        count_ = W;
+        cur_ = win_.front();
+        return;
+      }
+      done_ = true;
+    }
+
+    friend class minimizer_range;
+  };
+  typedef iterator const_iterator;
+
+  template <class Container>
+  explicit minimizer_range(const Container& c, Hash hash = Hash()) noexcept
+    : kmers_(c), hash_(hash) {}
+
+  template <class Container>
+  minimizer_range(const Container& c, size_type pos, size_type n, Hash hash = Hash()) noexcept
+    : kmers_(c, pos, n), hash_(hash) {}
+
+  iterator begin() const noexcept {return iterator(kmers_.begin(), kmers_.end(), hash_);}
+  iterator end() const noexcept {return iterator();}
+
+ private:
+  kmer_range<K> kmers_;
+  Hash hash_;
+};
+
+enum class syncmer_type { open, closed };
+
+//  Yields the syncmers of a packed sequence: the k-mers whose smallest
+//  canonical s-mer (by hash) sits at the given offset (open syncmers) or
+//  at either end of the k-mer (closed syncmers). Unlike minimizers the
+//  choice depends on the k-mer alone, not on its neighbours.
+template <unsigned K, unsigned S, class Hash = invertible_hash>
+class syncmer_range
+{
+  static_assert(S > 0 && S <= K, "an s-mer is a substring of the k-mer");
+  static constexpr unsigned __smers_per_kmer = K - S + 1;
+  typedef typename kmer_range<K>::iterator __kmer_iterator;
+  typedef typename kmer_range<S>::iterator __smer_iterator;
+ public:
+  typedef std::size_t size_type;
+
+  class iterator
+  {
+   public:
+    typedef std::ptrdiff_t            difference_type;
+    typedef seed                      value_type;
+    typedef const seed*               pointer;
+    typedef const seed&               reference;
+    typedef std::forward_iterator_tag iterator_category;
+
+    iterator() noexcept : cur_{0, 0, false}, type_(syncmer_type::closed), offset_(0), count_(0), done_(true) {}
+
+    reference operator*() const noexcept {return cur_;}
+    pointer operator->() const noexcept {return &cur_;}
+
+    iterator& operator++() noexcept
+    {
+      __next();
+      return *this;
+    }
+
+    iterator operator++(int) noexcept
+    {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const iterator& x, const iterator& y) noexcept
+    {return x.done_ == y.done_ && (x.done_ || x.cur_.position == y.cur_.position);}
+    friend bool operator!=(const iterator& x, const iterator& y) noexcept {return !(x == y);}
+
+   private:
+    __kmer_iterator kit_;
+    __smer_iterator sit_;
+    __smer_iterator slast_;
+    Hash hash_;
+    __seed_window<__smers_per_kmer> win_;
+    seed cur_;
+    syncmer_type type_;
+    unsigned offset_;
+    size_type count_;
+    bool done_;
+
+    iterator(__kmer_iterator kfirst, __smer_iterator sfirst, __smer_iterator slast,
+             syncmer_type type, unsigned offset, const Hash& hash) noexcept
+      : kit_(kfirst), sit_(sfirst), slast_(slast), hash_(hash), cur_{0, 0, false},
+        type_(type), offset_(offset), count_(0), done_(false)
+    {__next();}
+
+    void __next() noexcept
+    {
+      while (sit_ != slast_)
+      {
+        const kmer sm = *sit_++;
+        win_.slide(sm.position);
+        win_.push({hash_(sm.canonical(), kmer_range<S>::mask), sm.position, sm.is_reverse()});
+        if (++count_ < __smers_per_kmer)
+          continue;
+        // the window now covers exactly the s-mers of the k-mer at kit_
+        const kmer km = *kit_++;
+        const size_type rel = win_.front().position - km.position;
+        if (type_ == syncmer_type::open ? rel == offset_ : rel == 0 || rel == K - S)
+        {
+          cur_ = {hash_(km.canonical(), kmer_range<K>::mask), km.position, km.is_reverse()};
+          return;
+        }
+      }
+      done_ = true;
+    }
+
+    friend class syncmer_range;
+  };
+  typedef iterator const_iterator;
+
+  template <class Container>
+  explicit syncmer_range(const Container& c, syncmer_type type = syncmer_type::closed,
+                         unsigned offset = 0, Hash hash = Hash()) noexcept
+    : kmers_(c), smers_(c), type_(type), offset_(offset), hash_(hash) {}
+
+  template <class Container>
+  syncmer_range(const Container& c, size_type pos, size_type n, syncmer_type type = syncmer_type::closed,
+                unsigned offset = 0, Hash hash = Hash()) noexcept
+    : kmers_(c, pos, n), smers_(c, pos, n), type_(type), offset_(offset), hash_(hash) {}
+
+  iterator begin() const noexcept
+  {
+    if (kmers_.empty())
+      return end();
+    return iterator(kmers_.begin(), smers_.begin(), smers_.end(), type_, offset_, hash_);
+  }
+  iterator end() const noexcept {return iterator();}
+
+ private:
+  kmer_range<K> kmers_;
+  kmer_range<S> smers_;
+  syncmer_type type_;
+  unsigned offset_;
+  Hash hash_;
+};
+
+}
+
+#endif //BIOVOLTRON_MINIMIZER
@@ -0,0 +1,213 @@
+#ifndef BIOVOLTRON_MOTIF_SEARCH
+#define BIOVOLTRON_MOTIF_SEARCH
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <array>
+#include <bit>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "base_vector.hpp"
+#include "base_vector_set.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+struct motif_hit
+{
+  std::size_t pattern;   // index in the set the search was built from
+  std::size_t position;  // offset of the first base of the occurrence
+};
+
+class motif_search
+{
+ public:
+  typedef std::size_t size_type;
+
+  motif_search();
+  explicit motif_search(base_vector_set patterns);  // no pattern may be empty
+
+  size_type size() const noexcept;
+  const base_vector_set& patterns() const noexcept;
+  bool bit_parallel() const noexcept;  // all patterns fit one shift-and word
+
+  template <class Container>  // base_vector or base_vector_view
+  void find(const Container& text, std::vector<motif_hit>& hits) const;  // replaces the contents of hits
+};
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct motif_hit
+{
+  std::size_t pattern;
+  std::size_t position;
+
+  friend bool operator==(const motif_hit&, const motif_hit&) = default;
+};
+
+//  Finds every occurrence of a fixed set of patterns in one pass over the
+//  packed words of the text. When the patterns together fit in 64 bits,
+//  shift-and runs them side by side in one word, one shift, or and and per
+//  base. Otherwise the rolling code of the first k bases of each text
+//  position, k being the shortest pattern length up to 32, is looked up
+//  in a bit filter and then in the sorted pattern prefixes, and each
+//  candidate is verified with a word-level compare. Hits are not sorted.
+class motif_search
+{
+ public:
+  typedef std::size_t size_type;
+
+ private:
+  typedef std::uint64_t __word;
+
+  base_vector_set            patterns_;
+  // shift-and
+  std::array<__word, 4>      masks_{};   // bit j: base j of the concatenated patterns
+  __word                     starts_ = 0;
+  __word                     ends_ = 0;
+  std::vector<std::uint8_t>  owner_;     // pattern whose last base sits at each bit
+  // prefilter
+  unsigned                   k_ = 0;
+  unsigned                   filter_bits_ = 0;
+  std::vector<__word>        filter_;
+  std::vector<std::pair<__word, size_type>> prefixes_;  // (code of the first k bases, pattern)
+
+  static constexpr __word __golden = 0x9e3779b97f4a7c15;
+
+  size_type __filter_slot(__word code) const noexcept
+  {return static_cast<size_type>((code * __golden) >> (64 - filter_bits_));}
+
+  //  Calls f(i, c) for every base c at offset i of the packed text.
+  template <class Container, class F>
+  static void __scan(const Container& text, F f)
+  {
+    typedef std::remove_cvref_t<decltype(*std::to_address(text.data()))> __storage_type;
+    constexpr unsigned bases_per_word = sizeof(__storage_type) * CHAR_BIT / 2;
+    const __storage_type* w = std::to_address(text.data());
+    const size_type n = text.size();
+    size_type i = 0;
+    for (; i + bases_per_word <= n; ++w)
+      for (__storage_type x = *w, e = i + bases_per_word; i != e; ++i, x >>= 2)
+        f(i, static_cast<unsigned>(x & 3));
+    for (__storage_type x = n != i ? *w : 0; i != n; ++i, x >>= 2)
+      f(i, static_cast<unsigned>(x & 3));
+  }
+
+ public:
+  motif_search() = default;
+
+  explicit motif_search(base_vector_set patterns) : patterns_(std::move(patterns))
+  {
+    const size_type np = patterns_.size();
+    size_type shortest = -1;
+    for (size_type p = 0; p != np; ++p)
+    {
+      if (patterns_.length(p) == 0)
+        throw std::invalid_argument("motif_search: empty pattern");
+      shortest = std::min(shortest, patterns_.length(p));
+    }
+    if (np == 0)
+      return;
+
+    if (patterns_.total_size() <= 64)
+    {
+      owner_.resize(64);
+      const auto& off = patterns_.offsets();
+      for (size_type p = 0; p != np; ++p)
+      {
+        starts_ |= __word(1) << off[p];
+        ends_ |= __word(1) << (off[p + 1] - 1);
+        owner_[off[p + 1] - 1] = static_cast<std::uint8_t>(p);
+      }
+      size_type j = 0;
+      for (unsigned char c : patterns_.bases())
+        masks_[c] |= __word(1) << j++;
+      return;
+    }
+
+    k_ = static_cast<unsigned>(std::min<size_type>(shortest, 32));
+    filter_bits_ = 10;
+    while (filter_bits_ < 30 && (size_type(1) << filter_bits_) < 64 * np)
+      ++filter_bits_;
+    filter_.assign((size_type(1) << filter_bits_) / 64, 0);
+    prefixes_.reserve(np);
+    for (size_type p = 0; p != np; ++p)
+    {
+      __word code = 0;
+      auto it = patterns_[p].begin();
+      for (unsigned i = 0; i != k_; ++i, ++it)
+        code = code << 2 | static_cast<unsigned char>(*it);
+      prefixes_.emplace_back(code, p);
+      const size_type s = __filter_slot(code);
+      filter_[s / 64] |= __word(1) << (s % 64);
+    }
+    std::sort(prefixes_.begin(), prefixes_.end());
+  }
+
+  size_type size() const noexcept {return patterns_.size();}
+  const base_vector_set& patterns() const noexcept {return patterns_;}
+  bool bit_parallel() const noexcept {return starts_ != 0;}
+
+  template <class Container>
+  void find(const Container& text, std::vector<motif_hit>& hits) const
+  {
+    hits.clear();
+    if (patterns_.empty())
+      return;
+
+    if (bit_parallel())
+    {
+      // locals, so that the pushes into hits do not force reloads
+      const std::array<__word, 4> masks = masks_;
+      const __word starts = starts_, ends = ends_;
+      __word d = 0;
+      __scan(text, [&](size_type i, unsigned c)
+      {
+        d = (d << 1 | starts) & masks[c];
+        for (__word m = d & ends; m != 0; m &= m - 1)
+        {
+          const size_type p = owner_[std::countr_zero(m)];
+          hits.push_back({p, i + 1 - patterns_.length(p)});
+        }
+      });
+      return;
+    }
+
+    const unsigned k = k_, shift = 64 - filter_bits_;
+    const __word mask = k == 32 ? ~__word(0) : (__word(1) << (2 * k)) - 1;
+    const __word* filter = filter_.data();
+    const size_type n = text.size();
+    const auto first = text.begin();
+    __word code = 0;
+    __scan(text, [&](size_type i, unsigned c)
+    {
+      code = (code << 2 | c) & mask;
+      const size_type s = static_cast<size_type>((code * __golden) >> shift);
+      if ((filter[s / 64] >> (s % 64) & 1) == 0 || i + 1 < k)
+        return;
+      const size_type pos = i + 1 - k;
+      auto r = std::lower_bound(prefixes_.begin(), prefixes_.end(), std::pair<__word, size_type>(code, 0));
+      for (; r != prefixes_.end() && r->first == code; ++r)
+      {
+        const auto p = patterns_[r->second];
+        if (pos + p.size() <= n && biovoltron::equal(p.begin(), p.end(), first + pos))
+          hits.push_back({r->second, pos});
+      }
+    });
+  }
+};
+
+}
+
+#endif //BIOVOLTRON_MOTIF_SEARCH
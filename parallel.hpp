@@ -0,0 +1,265 @@
+#ifndef BIOVOLTRON_PARALLEL
+#define BIOVOLTRON_PARALLEL
+
+#include <cstddef>
+#include <climits>
+#include <array>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <compare>
+#include <numeric>
+#include <algorithm>
+#include <execution>
+#include <type_traits>
+#include "base_vector.hpp"
+
+/*
+
+Overloads of the bulk operations on packed sequences taking a standard
+execution policy. Work is split into pieces of parallel_grain bases whose
+inner boundaries fall on storage-word boundaries of the range written, so
+no two tasks ever write the same word. Ranges passed to copy must not
+overlap. Container is base_vector or small_base_vector<N>.
+
+namespace biovoltron
+{
+
+inline constexpr std::size_t parallel_grain = 1 << 20;
+
+template <class ExecutionPolicy, class Cp, bool IsConst>
+  base_iterator<Cp, false>
+  copy(ExecutionPolicy&& policy, base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+       base_iterator<Cp, false> result);
+template <class ExecutionPolicy, class Cp>
+  base_iterator<Cp, false>
+  fill_n(ExecutionPolicy&& policy, base_iterator<Cp, false> first, typename Cp::size_type n, unsigned char x);
+template <class ExecutionPolicy, class Cp>
+  void fill(ExecutionPolicy&& policy, base_iterator<Cp, false> first, base_iterator<Cp, false> last, unsigned char x);
+template <class ExecutionPolicy, class Cp, bool IsConst>
+  typename base_iterator<Cp, IsConst>::difference_type
+  count(ExecutionPolicy&& policy, base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, unsigned char x);
+template <class ExecutionPolicy, class Cp, bool IsConst>
+  std::array<typename Cp::size_type, 4>
+  histogram(ExecutionPolicy&& policy, base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last);
+template <class ExecutionPolicy, class Cp, bool IC1, bool IC2>
+  std::pair<base_iterator<Cp, IC1>, base_iterator<Cp, IC2>>
+  mismatch(ExecutionPolicy&& policy, base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1,
+           base_iterator<Cp, IC2> first2, base_iterator<Cp, IC2> last2);
+template <class ExecutionPolicy, class Cp, bool IC1, bool IC2>
+  bool equal(ExecutionPolicy&& policy, base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1,
+             base_iterator<Cp, IC2> first2);
+
+template <class ExecutionPolicy, class Container>
+  void flip(ExecutionPolicy&& policy, Container& v);
+template <class ExecutionPolicy, class Container>
+  void reverse_complement(ExecutionPolicy&& policy, Container& v);
+template <class ExecutionPolicy, class Container>
+  std::strong_ordering compare(ExecutionPolicy&& policy, const Container& x, const Container& y);
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+inline constexpr std::size_t parallel_grain = 1 << 20;
+
+template <class ExecutionPolicy>
+concept __execution_policy = std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>;
+
+//  Splits n elements, the first of which sits in slot pos of its word, into
+//  (offset, length) pieces of about grain elements. Every piece but the
+//  first starts on a word boundary.
+//  Precondition:  grain is a multiple of the elements per word
+inline std::vector<std::pair<std::size_t, std::size_t>>
+__chunks(unsigned pos, std::size_t n, std::size_t grain = parallel_grain)
+{
+  std::vector<std::pair<std::size_t, std::size_t>> r;
+  r.reserve(n / grain + 2);
+  for (std::size_t off = 0, len = grain - pos; off < n; off += len, len = grain)
+  {
+    len = std::min(len, n - off);
+    r.emplace_back(off, len);
+  }
+  return r;
+}
+
+template <class ExecutionPolicy, class Cp, bool IsConst>
+  requires __execution_policy<ExecutionPolicy>
+base_iterator<Cp, false>
+copy(ExecutionPolicy&& policy, base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last,
+     base_iterator<Cp, false> result)
+{
+  const auto c = __chunks(__slot(result), last - first);
+  std::for_each(policy, c.begin(), c.end(), [=](const auto& p)
+  {biovoltron::copy(first + p.first, first + (p.first + p.second), result + p.first);});
+  return result + (last - first);
+}
+
+template <class ExecutionPolicy, class Cp>
+  requires __execution_policy<ExecutionPolicy>
+base_iterator<Cp, false>
+fill_n(ExecutionPolicy&& policy, base_iterator<Cp, false> first, typename Cp::size_type n, unsigned char x)
+{
+  const auto c = __chunks(__slot(first), n);
+  std::for_each(policy, c.begin(), c.end(), [=](const auto& p)
+  {biovoltron::fill_n(first + p.first, p.second, x);});
+  return first + n;
+}
+
+template <class ExecutionPolicy, class Cp>
+  requires __execution_policy<ExecutionPolicy>
+void fill(ExecutionPolicy&& policy, base_iterator<Cp, false> first, base_iterator<Cp, false> last, unsigned char x)
+{biovoltron::fill_n(policy, first, static_cast<typename Cp::size_type>(last - first), x);}
+
+template <class ExecutionPolicy, class Cp, bool IsConst>
+  requires __execution_policy<ExecutionPolicy>
+typename base_iterator<Cp, IsConst>::difference_type
+count(ExecutionPolicy&& policy, base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, unsigned char x)
+{
+  typedef typename base_iterator<Cp, IsConst>::difference_type difference_type;
+  const auto c = __chunks(__slot(first), last - first);
+  return std::transform_reduce(policy, c.begin(), c.end(), difference_type(0), std::plus<>(),
+                               [=](const auto& p)
+  {return biovoltron::count(first + p.first, first + (p.first + p.second), x);});
+}
+
+template <class ExecutionPolicy, class Cp, bool IsConst>
+  requires __execution_policy<ExecutionPolicy>
+std::array<typename Cp::size_type, 4>
+histogram(ExecutionPolicy&& policy, base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last)
+{
+  typedef std::array<typename Cp::size_type, 4> __hist;
+  const auto c = __chunks(__slot(first), last - first);
+  return std::transform_reduce(policy, c.begin(), c.end(), __hist{},
+                               [](__hist a, const __hist& b)
+                               {
+                                 for (unsigned i = 0; i != 4; ++i)
+                                   a[i] += b[i];
+                                 return a;
+                               },
+                               [=](const auto& p)
+  {return biovoltron::histogram(first + p.first, first + (p.first + p.second));});
+}
+
+//  Every piece reports its first mismatch; the earliest one wins.
+template <class ExecutionPolicy, class Cp, bool IC1, bool IC2>
+  requires __execution_policy<ExecutionPolicy>
+std::pair<base_iterator<Cp, IC1>, base_iterator<Cp, IC2>>
+mismatch(ExecutionPolicy&& policy, base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1,
+         base_iterator<Cp, IC2> first2, base_iterator<Cp, IC2> last2)
+{
+  const std::size_t n = std::min(last1 - first1, last2 - first2);
+  const auto c = __chunks(__slot(first1), n);
+  std::vector<std::size_t> at(c.size());
+  std::transform(policy, c.begin(), c.end(), at.begin(), [=](const auto& p)
+  {
+    auto i = biovoltron::mismatch(first1 + p.first, first1 + (p.first + p.second), first2 + p.first).first;
+    return static_cast<std::size_t>(i - first1);
+  });
+  std::size_t d = n;
+  for (std::size_t k = 0; k != c.size(); ++k)
+    if (at[k] != c[k].first + c[k].second)
+    {
+      d = at[k];
+      break;
+    }
+  return {first1 + d, first2 + d};
+}
+
+template <class ExecutionPolicy, class Cp, bool IC1, bool IC2>
+  requires __execution_policy<ExecutionPolicy>
+bool equal(ExecutionPolicy&& policy, base_iterator<Cp, IC1> first1, base_iterator<Cp, IC1> last1,
+           base_iterator<Cp, IC2> first2)
+{
+  const auto c = __chunks(__slot(first1), last1 - first1);
+  return std::transform_reduce(policy, c.begin(), c.end(), true, std::logical_and<>(), [=](const auto& p)
+  {return biovoltron::equal(first1 + p.first, first1 + (p.first + p.second), first2 + p.first);});
+}
+
+template <class ExecutionPolicy, class Container>
+  requires __execution_policy<ExecutionPolicy>
+void flip(ExecutionPolicy&& policy, Container& v)
+{
+  typedef typename Container::__storage_type __storage_type;
+  constexpr unsigned bases_per_word = Container::bases_per_word;
+  __storage_type* w = std::to_address(v.data());
+  const std::size_t n = v.size();
+  const auto c = __chunks(0, n / bases_per_word, parallel_grain / bases_per_word);
+  std::for_each(policy, c.begin(), c.end(), [=](const auto& p)
+  {
+    for (std::size_t i = p.first; i != p.first + p.second; ++i)
+      w[i] = ~w[i];
+  });
+  if (const unsigned r = n % bases_per_word)
+    w[n / bases_per_word] ^= ~(~__storage_type(0) << (2 * r));
+}
+
+//  Reverses and complements the words pairwise from both ends, then shifts
+//  the padding of the last word out of the front. Each piece of the shift
+//  reads one word past its end; those words are saved before any piece
+//  runs.
+template <class ExecutionPolicy, class Container>
+  requires __execution_policy<ExecutionPolicy>
+void reverse_complement(ExecutionPolicy&& policy, Container& v)
+{
+  typedef typename Container::__storage_type __storage_type;
+  constexpr unsigned bases_per_word = Container::bases_per_word;
+  constexpr unsigned bits_per_word = bases_per_word * 2;
+  constexpr std::size_t grain = parallel_grain / bases_per_word;
+  const std::size_t n = v.size();
+  if (n == 0)
+    return;
+  __storage_type* w = std::to_address(v.data());
+  const std::size_t nw = (n - 1) / bases_per_word + 1;
+
+  const auto h = __chunks(0, (nw + 1) / 2, grain);
+  std::for_each(policy, h.begin(), h.end(), [=](const auto& p)
+  {
+    for (std::size_t i = p.first; i != p.first + p.second; ++i)
+    {
+      const std::size_t j = nw - 1 - i;
+      const __storage_type t = ~__reverse_slots(w[i]);
+      w[i] = ~__reverse_slots(w[j]);
+      w[j] = t;
+    }
+  });
+
+  const unsigned r = n % bases_per_word;
+  if (r == 0)
+    return;
+  const unsigned s = (bases_per_word - r) * 2;
+  const auto c = __chunks(0, nw, grain);
+  std::vector<__storage_type> next(c.size());
+  for (std::size_t k = 0; k + 1 < c.size(); ++k)
+    next[k] = w[c[k + 1].first];
+  std::vector<std::size_t> k(c.size());
+  std::iota(k.begin(), k.end(), std::size_t(0));
+  const __storage_type* nx = next.data();
+  const auto* cs = c.data();
+  std::for_each(policy, k.begin(), k.end(), [=](std::size_t k)
+  {
+    const std::size_t last = cs[k].first + cs[k].second;
+    for (std::size_t i = cs[k].first; i != last; ++i)
+    {
+      const __storage_type u = i + 1 != last ? w[i + 1] : nx[k];
+      w[i] = w[i] >> s | u << (bits_per_word - s);
+    }
+  });
+}
+
+template <class ExecutionPolicy, class Container>
+  requires __execution_policy<ExecutionPolicy>
+std::strong_ordering compare(ExecutionPolicy&& policy, const Container& x, const Container& y)
+{
+  auto [i, j] = biovoltron::mismatch(policy, x.begin(), x.end(), y.begin(), y.end());
+  if (i == x.end() || j == y.end())
+    return x.size() <=> y.size();
+  return static_cast<unsigned char>(*i) <=> static_cast<unsigned char>(*j);
+}
+
+}
+
+#endif //BIOVOLTRON_PARALLEL
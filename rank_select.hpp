@@ -0,0 +1,216 @@
+#ifndef BIOVOLTRON_RANK_SELECT
+#define BIOVOLTRON_RANK_SELECT
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <array>
+#include <bit>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+/*
+
+namespace biovoltron
+{
+
+//  Holds its own copy of the sequence, so it replaces the container rather
+//  than sitting beside it. 2 bits per base for the sequence, 64 bits of
+//  counts per block of 224 bases and 256 bits per superblock of 57344
+//  bases: about 2.29 bits per base, plus one select sample per 8192
+//  occurrences of each symbol.
+class rank_select
+{
+ public:
+  typedef std::size_t size_type;
+
+  static constexpr size_type bases_per_block;       // 7 storage words, one cache line with the counts
+  static constexpr size_type bases_per_superblock;  // 256 blocks
+  static constexpr size_type select_sample_rate;    // occurrences between select samples
+
+  rank_select() noexcept;
+  template <class Container>  // base_vector, small_base_vector<N> or vector<uint2_t>
+  explicit rank_select(const Container& c);
+
+  size_type size() const noexcept;
+  unsigned char operator[](size_type i) const noexcept;
+
+  size_type count(unsigned char c) const noexcept;                 // occurrences of c
+  size_type rank(unsigned char c, size_type i) const noexcept;     // occurrences of c in [0, i)
+  std::array<size_type, 4> rank(size_type i) const noexcept;       // all four at once
+  size_type select(unsigned char c, size_type k) const noexcept;   // position of occurrence k (from 0) of c
+                                                                   // Precondition:  k < count(c)
+};
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+//  A copy of a packed sequence laid out for rank queries. Every 64-byte
+//  block holds four 16-bit counts of the symbols before it, taken from the
+//  start of its superblock, followed by seven storage words; the 64-bit
+//  totals before each superblock of 256 blocks live apart and are small
+//  enough to stay cached. rank(c, i) thus reads one block line and one
+//  superblock entry and does seven popcounts at most. select goes from a
+//  sampled block to the right block by binary search over the counts,
+//  then scans that block.
+class rank_select
+{
+ public:
+  typedef std::size_t size_type;
+ private:
+  typedef std::size_t __storage_type;
+
+  static constexpr unsigned bases_per_word = sizeof(__storage_type) * CHAR_BIT / 2;
+  static constexpr unsigned bits_per_word = bases_per_word * 2;
+  static constexpr unsigned __words_per_block = 7;
+  static constexpr size_type __blocks_per_superblock = 256;
+ public:
+  static constexpr size_type bases_per_block = __words_per_block * bases_per_word;
+  static constexpr size_type bases_per_superblock = __blocks_per_superblock * bases_per_block;
+  static constexpr size_type select_sample_rate = 8192;
+ private:
+  struct alignas(64) __block
+  {
+    std::uint16_t  count[4];  // from the start of the superblock
+    __storage_type word[__words_per_block];
+  };
+  static_assert(sizeof(__block) == 64, "a block is one cache line");
+  static_assert(bases_per_superblock <= 65536, "in-superblock counts must fit 16 bits");
+
+  std::vector<__block> blocks_;
+  std::vector<std::array<size_type, 4>> supers_;   // counts before each superblock
+  std::array<std::vector<size_type>, 4> samples_;  // block holding occurrence k * select_sample_rate
+  std::array<size_type, 4> totals_{};
+  size_type size_ = 0;
+
+  //  Even bit 2j is set when slot j of w holds c.
+  static __storage_type __match(__storage_type w, unsigned char c) noexcept
+  {
+    constexpr __storage_type lo = ~__storage_type(0) / 3;
+    const __storage_type x = w ^ (lo * c);
+    return ~(x | x >> 1) & lo;
+  }
+
+  static __storage_type __low_slots(unsigned n) noexcept
+  {return n == 0 ? 0 : ~__storage_type(0) >> (bits_per_word - 2 * n);}
+
+  //  Occurrences of c before block b.
+  size_type __before(size_type b, unsigned char c) const noexcept
+  {return supers_[b / __blocks_per_superblock][c] + blocks_[b].count[c];}
+
+ public:
+  rank_select() noexcept = default;
+
+  template <class Container>
+  explicit rank_select(const Container& c) : size_(c.size())
+  {
+    static_assert(sizeof(*std::to_address(c.data())) == sizeof(__storage_type), "storage words must match");
+    const __storage_type* src = std::to_address(c.data());
+    const size_type nw = (size_ + bases_per_word - 1) / bases_per_word;
+    blocks_.resize(size_ / bases_per_block + 1);
+    supers_.reserve((blocks_.size() - 1) / __blocks_per_superblock + 1);
+    for (unsigned x = 0; x != 4; ++x)
+      samples_[x].reserve(size_ / select_sample_rate / 4 + 1);
+
+    std::array<size_type, 4> run{};
+    for (size_type b = 0; b != blocks_.size(); ++b)
+    {
+      if (b % __blocks_per_superblock == 0)
+        supers_.push_back(run);
+      __block& blk = blocks_[b];
+      const std::array<size_type, 4> before = run;
+      for (unsigned x = 0; x != 4; ++x)
+        blk.count[x] = static_cast<std::uint16_t>(run[x] - supers_.back()[x]);
+      for (unsigned j = 0; j != __words_per_block; ++j)
+      {
+        const size_type i = b * __words_per_block + j;
+        const size_type valid = i < nw ? std::min<size_type>(bases_per_word, size_ - i * bases_per_word) : 0;
+        const __storage_type w = valid == 0 ? 0 : src[i] & __low_slots(valid);
+        blk.word[j] = w;
+        if (valid == 0)
+          continue;
+        const __storage_type m = __low_slots(valid);
+        for (unsigned x = 0; x != 4; ++x)
+          run[x] += std::popcount(__match(w, x) & m);
+      }
+      for (unsigned x = 0; x != 4; ++x)
+        for (size_type k = (before[x] + select_sample_rate - 1) / select_sample_rate * select_sample_rate;
+             k < run[x]; k += select_sample_rate)
+          samples_[x].push_back(b);
+    }
+    totals_ = run;
+  }
+
+  size_type size() const noexcept {return size_;}
+
+  unsigned char operator[](size_type i) const noexcept
+  {
+    const __block& blk = blocks_[i / bases_per_block];
+    const size_type r = i % bases_per_block;
+    return blk.word[r / bases_per_word] >> (2 * (r % bases_per_word)) & 3;
+  }
+
+  size_type count(unsigned char c) const noexcept {return totals_[c];}
+
+  size_type rank(unsigned char c, size_type i) const noexcept
+  {
+    const __block& blk = blocks_[i / bases_per_block];
+    const size_type r = i % bases_per_block;
+    const unsigned full = static_cast<unsigned>(r / bases_per_word);
+    size_type n = __before(i / bases_per_block, c);
+    for (unsigned j = 0; j != full; ++j)
+      n += std::popcount(__match(blk.word[j], c));
+    if (const unsigned rest = r % bases_per_word)
+      n += std::popcount(__match(blk.word[full], c) & __low_slots(rest));
+    return n;
+  }
+
+  std::array<size_type, 4> rank(size_type i) const noexcept
+  {
+    std::array<size_type, 4> n;
+    for (unsigned x = 0; x != 4; ++x)
+      n[x] = rank(x, i);
+    return n;
+  }
+
+  size_type select(unsigned char c, size_type k) const noexcept
+  {
+    const std::vector<size_type>& s = samples_[c];
+    const size_type t = k / select_sample_rate;
+    const size_type lo = s[t];
+    const size_type hi = t + 1 < s.size() ? s[t + 1] + 1 : blocks_.size();
+    // the last block in [lo, hi) with at most k occurrences before it
+    size_type b = lo, len = hi - lo;
+    while (len > 1)
+    {
+      const size_type half = len / 2;
+      if (__before(b + half, c) <= k)
+        b += half, len -= half;
+      else
+        len = half;
+    }
+    const __block& blk = blocks_[b];
+    size_type need = k - __before(b, c);
+    for (unsigned j = 0;; ++j)
+    {
+      __storage_type m = __match(blk.word[j], c);
+      const unsigned pc = std::popcount(m);
+      if (need < pc)
+      {
+        for (; need != 0; --need)
+          m &= m - 1;
+        return b * bases_per_block + j * bases_per_word + std::countr_zero(m) / 2;
+      }
+      need -= pc;
+    }
+  }
+};
+
+}
+
+#endif //BIOVOLTRON_RANK_SELECT
@@ -0,0 +1,345 @@
+#ifndef BIOVOLTRON_SEGMENTED
+#define BIOVOLTRON_SEGMENTED
+
+#include <cstddef>
+#include <climits>
+#include <type_traits>
+#include <concepts>
+#include <utility>
+#include <iterator>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include "uint2_t.hpp"
+#include "base_vector.hpp"
+
+/*
+
+A packed iterator is a word pointer (its segment) and a slot within that
+word (its local position). segmented_iterator_traits exposes the pair, so
+an algorithm can walk the storage words directly instead of dereferencing
+one element at a time, and rebuild an iterator from a word and a slot
+when it is done. It is specialized for base_vector's iterators (shared by
+base_vector_view, small_base_vector and the spans) and vector<uint2_t>'s.
+
+copy, copy_backward, fill, fill_n, count, mismatch and equal already take
+these iterators word by word (base_vector.hpp, uint2_t.hpp); find,
+reverse, rotate and transform below complete the set, and transform_bases
+applies a base-to-base map with word operations alone. All of them accept a
+range starting at any slot: the words are read and written shifted
+together from the two neighbours they straddle.
+
+namespace biovoltron
+{
+
+template <class Iterator>
+struct segmented_iterator_traits
+{
+  typedef implementation-defined segment_iterator;  // pointer to the storage words
+  typedef implementation-defined word_type;         // the storage word
+
+  static constexpr unsigned elements_per_word;
+
+  static segment_iterator segment(Iterator it) noexcept;   // word holding *it
+  static unsigned local(Iterator it) noexcept;             // slot of *it in that word
+  static Iterator compose(segment_iterator seg, unsigned pos) noexcept;  // Precondition:  pos < elements_per_word
+};
+
+template <class Iterator>
+  concept segmented_iterator;  // segmented_iterator_traits<Iterator> is specialized
+
+template <class Cp, bool IsConst, std::integral T>
+  base_iterator<Cp, IsConst>
+  find(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, const T& x);
+template <class Cp>
+  void reverse(base_iterator<Cp, false> first, base_iterator<Cp, false> last);
+template <class Cp>
+  base_iterator<Cp, false>
+  rotate(base_iterator<Cp, false> first, base_iterator<Cp, false> middle, base_iterator<Cp, false> last);
+template <class Cp, bool IsConst, class UnaryOperation>  // op is called once per element
+  base_iterator<Cp, false>
+  transform(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, base_iterator<Cp, false> result,
+            UnaryOperation op);
+
+// op is called on the four values only, so it must be a pure function of
+// its argument; complement and other fixed xors cost one xor per word
+template <segmented_iterator Iterator1, segmented_iterator Iterator2, class UnaryOperation>
+  Iterator2 transform_bases(Iterator1 first, Iterator1 last, Iterator2 result, UnaryOperation op);
+
+}  // biovoltron
+
+namespace std
+{
+
+// the same four for detail::__uint2_iterator (vector<uint2_t>::iterator)
+template <class Cp, bool IsConst, std::integral T>
+  detail::__uint2_iterator<Cp, IsConst>
+  find(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last, const T& x);
+template <class Cp>
+  void reverse(detail::__uint2_iterator<Cp, false> first, detail::__uint2_iterator<Cp, false> last);
+template <class Cp>
+  detail::__uint2_iterator<Cp, false>
+  rotate(detail::__uint2_iterator<Cp, false> first, detail::__uint2_iterator<Cp, false> middle,
+         detail::__uint2_iterator<Cp, false> last);
+template <class Cp, bool IsConst, class UnaryOperation>
+  detail::__uint2_iterator<Cp, false>
+  transform(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last,
+            detail::__uint2_iterator<Cp, false> result, UnaryOperation op);
+
+}  // std
+
+*/
+
+namespace biovoltron
+{
+
+template <class Cp, bool IsConst>
+struct segmented_iterator_traits<base_iterator<Cp, IsConst>>
+{
+  typedef base_iterator<Cp, IsConst>             iterator;
+  typedef typename iterator::__storage_pointer   segment_iterator;
+  typedef typename iterator::__storage_type      word_type;
+
+  static constexpr unsigned elements_per_word = iterator::bases_per_word;
+
+  static segment_iterator segment(iterator it) noexcept {return it.seg_;}
+  static unsigned local(iterator it) noexcept {return it.pos_;}
+  static iterator compose(segment_iterator seg, unsigned pos) noexcept {return iterator(seg, pos);}
+};
+
+template <class Cp, bool IsConst>
+struct segmented_iterator_traits<detail::__uint2_iterator<Cp, IsConst>>
+{
+  typedef detail::__uint2_iterator<Cp, IsConst>  iterator;
+  typedef typename iterator::__storage_pointer   segment_iterator;
+  typedef typename iterator::__storage_type      word_type;
+
+  static constexpr unsigned elements_per_word = iterator::uint2_per_word;
+
+  static segment_iterator segment(iterator it) noexcept {return it.seg_;}
+  static unsigned local(iterator it) noexcept {return it.pos_;}
+  static iterator compose(segment_iterator seg, unsigned pos) noexcept {return iterator(seg, pos);}
+};
+
+template <class Iterator>
+concept segmented_iterator = requires (Iterator it)
+{
+  segmented_iterator_traits<Iterator>::segment(it);
+  segmented_iterator_traits<Iterator>::local(it);
+};
+
+// find
+
+//  Xoring a word with x copied into every slot zeroes the slots holding x;
+//  the lowest such slot is the first match.
+template <segmented_iterator It>
+It __find(It first, It last, unsigned char x)
+{
+  typedef segmented_iterator_traits<It> Tr;
+  typedef typename Tr::word_type        __storage_type;
+  typedef typename std::iterator_traits<It>::difference_type difference_type;
+  const unsigned elements_per_word = Tr::elements_per_word;
+  const unsigned bits_per_word = elements_per_word * 2;
+  const __storage_type lo_bits = ~__storage_type(0) / 3;
+  const __storage_type pattern = lo_bits * x;
+  auto seg = Tr::segment(first);
+  const unsigned ctz = Tr::local(first) * 2;
+  const difference_type n = last - first;
+  for (difference_type i = 0; i < n; i += elements_per_word, ++seg)
+  {
+    const unsigned nb = n - i < elements_per_word ? static_cast<unsigned>(n - i) * 2 : bits_per_word;
+    const __storage_type d = __load_word<__storage_type>(seg, ctz, nb) ^ pattern;
+    __storage_type m = ~(d | d >> 1) & lo_bits;
+    if (nb < bits_per_word)
+      m &= ~(~__storage_type(0) << nb);
+    if (m != 0)
+      return first + (i + std::countr_zero(m) / 2);
+  }
+  return last;
+}
+
+// reverse
+
+//  Swaps a word from each end, each reversed slot by slot, until at most
+//  two words are left; those are swapped as two halves shifted down to
+//  their width, the odd middle element staying in place.
+template <segmented_iterator It>
+void __reverse(It first, It last)
+{
+  typedef segmented_iterator_traits<It> Tr;
+  typedef typename Tr::word_type        __storage_type;
+  typedef typename std::iterator_traits<It>::difference_type difference_type;
+  const unsigned elements_per_word = Tr::elements_per_word;
+  const unsigned bits_per_word = elements_per_word * 2;
+  difference_type n = last - first;
+  for (; n > 2 * static_cast<difference_type>(elements_per_word); n -= 2 * elements_per_word)
+  {
+    last -= elements_per_word;
+    const auto s1 = Tr::segment(first), s2 = Tr::segment(last);
+    const unsigned c1 = Tr::local(first) * 2, c2 = Tr::local(last) * 2;
+    const __storage_type a = __load_word<__storage_type>(s1, c1, bits_per_word);
+    const __storage_type b = __load_word<__storage_type>(s2, c2, bits_per_word);
+    __store_word(s1, c1, bits_per_word, __reverse_slots(b));
+    __store_word(s2, c2, bits_per_word, __reverse_slots(a));
+    first += elements_per_word;
+  }
+  if (n < 2)
+    return;
+  const auto h = static_cast<unsigned>(n / 2);
+  last = first + (n - h);
+  const auto s1 = Tr::segment(first), s2 = Tr::segment(last);
+  const unsigned c1 = Tr::local(first) * 2, c2 = Tr::local(last) * 2, nb = h * 2;
+  const __storage_type a = __load_word<__storage_type>(s1, c1, nb);
+  const __storage_type b = __load_word<__storage_type>(s2, c2, nb);
+  __store_word(s1, c1, nb, __reverse_slots(b) >> (bits_per_word - nb));
+  __store_word(s2, c2, nb, __reverse_slots(a) >> (bits_per_word - nb));
+}
+
+// rotate
+
+//  Three word-level reversals: no buffer, and each pass streams the words.
+template <segmented_iterator It>
+It __rotate(It first, It middle, It last)
+{
+  if (first == middle)
+    return last;
+  if (middle == last)
+    return first;
+  __reverse(first, middle);
+  __reverse(middle, last);
+  __reverse(first, last);
+  return first + (last - middle);
+}
+
+// transform
+
+//  Rewrites the n elements from first into result a word at a time:
+//  f(w, k) returns the word holding the new values of the k elements of w.
+template <segmented_iterator It1, segmented_iterator It2, class F>
+It2 __transform_words(It1 first, It1 last, It2 result, F f)
+{
+  typedef segmented_iterator_traits<It1> Tr1;
+  typedef segmented_iterator_traits<It2> Tr2;
+  typedef typename Tr1::word_type        __storage_type;
+  typedef typename std::iterator_traits<It1>::difference_type difference_type;
+  static_assert(std::is_same_v<__storage_type, typename Tr2::word_type>, "transform needs equal storage words");
+  const unsigned elements_per_word = Tr1::elements_per_word;
+  auto seg1 = Tr1::segment(first);
+  auto seg2 = Tr2::segment(result);
+  const unsigned ctz1 = Tr1::local(first) * 2;
+  const unsigned ctz2 = Tr2::local(result) * 2;
+  const difference_type n = last - first;
+  for (difference_type i = 0; i < n; i += elements_per_word, ++seg1, ++seg2)
+  {
+    const unsigned k = n - i < elements_per_word ? static_cast<unsigned>(n - i) : elements_per_word;
+    __store_word(seg2, ctz2, k * 2, f(__load_word<__storage_type>(seg1, ctz1, k * 2), k));
+  }
+  return result + n;
+}
+
+//  Calls op once per element, in order, as std::transform does; only the
+//  loads and stores are by word.
+template <segmented_iterator It1, segmented_iterator It2, class UnaryOperation>
+It2 __transform(It1 first, It1 last, It2 result, UnaryOperation op)
+{
+  typedef typename segmented_iterator_traits<It1>::word_type __storage_type;
+  typedef typename std::iterator_traits<It1>::value_type     value_type;
+  return __transform_words(first, last, result, [&op](__storage_type w, unsigned k)
+  {
+    __storage_type r = 0;
+    for (unsigned j = 0; j != k; ++j)
+      r |= __storage_type(static_cast<unsigned char>(op(static_cast<value_type>(w >> 2 * j & 3))) & 3) << 2 * j;
+    return r;
+  });
+}
+
+//  op is tabulated on the four values once, so it must be a pure function
+//  of its argument. A table that is a fixed xor of its input (identity,
+//  complement, ...) is one xor per word; any other is applied as a masked
+//  select per value.
+template <segmented_iterator It1, segmented_iterator It2, class UnaryOperation>
+It2 transform_bases(It1 first, It1 last, It2 result, UnaryOperation op)
+{
+  typedef typename segmented_iterator_traits<It1>::word_type __storage_type;
+  typedef typename std::iterator_traits<It1>::value_type     value_type;
+  const __storage_type lo_bits = ~__storage_type(0) / 3;
+  __storage_type table[4];
+  bool xor_table = true;
+  for (unsigned c = 0; c != 4; ++c)
+  {
+    table[c] = lo_bits * (static_cast<unsigned char>(op(static_cast<value_type>(c))) & 3);
+    xor_table = xor_table && table[c] == (table[0] ^ (lo_bits * c));
+  }
+  if (xor_table)
+    return __transform_words(first, last, result, [&](__storage_type w, unsigned) {return w ^ table[0];});
+  return __transform_words(first, last, result, [&](__storage_type w, unsigned)
+  {
+    __storage_type r = 0;
+    for (unsigned c = 0; c != 4; ++c)
+    {
+      const __storage_type d = w ^ (lo_bits * c);
+      r |= (~(d | d >> 1) & lo_bits) * 3 & table[c];
+    }
+    return r;
+  });
+}
+
+//  x is a template parameter so that this stays more specialized than
+//  std::find for integer literals too.
+template <class Cp, bool IsConst, std::integral T>
+inline base_iterator<Cp, IsConst>
+find(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, const T& x)
+{
+  if (std::cmp_less(x, 0) || std::cmp_greater(x, 3))
+    return last;
+  return __find(first, last, static_cast<unsigned char>(x));
+}
+
+template <class Cp>
+inline void reverse(base_iterator<Cp, false> first, base_iterator<Cp, false> last)
+{__reverse(first, last);}
+
+template <class Cp>
+inline base_iterator<Cp, false>
+rotate(base_iterator<Cp, false> first, base_iterator<Cp, false> middle, base_iterator<Cp, false> last)
+{return __rotate(first, middle, last);}
+
+template <class Cp, bool IsConst, class UnaryOperation>
+inline base_iterator<Cp, false>
+transform(base_iterator<Cp, IsConst> first, base_iterator<Cp, IsConst> last, base_iterator<Cp, false> result,
+          UnaryOperation op)
+{return __transform(first, last, result, op);}
+
+}
+
+namespace std
+{
+
+template <class Cp, bool IsConst, std::integral T>
+inline detail::__uint2_iterator<Cp, IsConst>
+find(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last, const T& x)
+{
+  if (std::cmp_less(x, 0) || std::cmp_greater(x, 3))
+    return last;
+  return biovoltron::__find(first, last, static_cast<unsigned char>(x));
+}
+
+template <class Cp>
+inline void reverse(detail::__uint2_iterator<Cp, false> first, detail::__uint2_iterator<Cp, false> last)
+{biovoltron::__reverse(first, last);}
+
+template <class Cp>
+inline detail::__uint2_iterator<Cp, false>
+rotate(detail::__uint2_iterator<Cp, false> first, detail::__uint2_iterator<Cp, false> middle,
+       detail::__uint2_iterator<Cp, false> last)
+{return biovoltron::__rotate(first, middle, last);}
+
+template <class Cp, bool IsConst, class UnaryOperation>
+inline detail::__uint2_iterator<Cp, false>
+transform(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last,
+          detail::__uint2_iterator<Cp, false> result, UnaryOperation op)
+{return biovoltron::__transform(first, last, result, op);}
+
+}
+
+#endif //BIOVOLTRON_SEGMENTED
@@ -0,0 +1,256 @@
+#ifndef BIOVOLTRON_SEQUENCE_READER
+#define BIOVOLTRON_SEQUENCE_READER
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <istream>
+#include <stdexcept>
+#include "base_vector.hpp"
+#include "ascii.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+struct sequence_record
+{
+  std::string name;                                            // header line without '>' or '@'
+  base_vector seq;                                             // A=0 C=1 G=2 T/U=3, anything else 0
+  std::string qual;                                            // FASTQ only
+  std::vector<std::pair<std::size_t, std::size_t>> ambiguous;  // [first, last) runs of non-ACGT
+};
+
+class sequence_reader
+{
+ public:
+  static constexpr std::size_t default_block_size = 1 << 20;
+
+  explicit sequence_reader(std::istream& is, std::size_t block_size = default_block_size);
+
+  bool read(sequence_record& r);  // false once the input is exhausted
+};
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct sequence_record
+{
+  std::string name;
+  base_vector seq;
+  std::string qual;
+  std::vector<std::pair<std::size_t, std::size_t>> ambiguous;
+};
+
+//  Packs bases into a base_vector a whole storage word at a time. The
+//  vector is grown in large steps and its words are written through data();
+//  finish() trims it to the number of bases seen.
+class __base_packer
+{
+  typedef base_vector::size_type      size_type;
+  typedef base_vector::__storage_type __storage_type;
+  static constexpr unsigned bits_per_word = base_vector::bases_per_word * 2;
+
+  base_vector& seq_;
+  std::vector<std::pair<size_type, size_type>>& ambiguous_;
+  __storage_type word_ = 0;
+  unsigned shift_ = 0;
+  size_type n_ = 0;
+
+  //  Writes word_ as storage word i, which holds bases below n_.
+  void __store(size_type i)
+  {
+    if (seq_.size() < n_)
+      seq_.resize(std::max(n_, 2 * seq_.size()));
+    seq_.data()[i] = word_;
+  }
+
+  void __ambiguous()
+  {
+    if (!ambiguous_.empty() && ambiguous_.back().second == n_)
+      ++ambiguous_.back().second;
+    else
+      ambiguous_.emplace_back(n_, n_ + 1);
+  }
+
+ public:
+  __base_packer(base_vector& seq, std::vector<std::pair<size_type, size_type>>& ambiguous) noexcept
+    : seq_(seq), ambiguous_(ambiguous) {}
+
+  size_type size() const noexcept {return n_;}
+
+  void push(unsigned char c)
+  {
+    unsigned char b = __ascii_to_base[c];
+    if (b == 5)
+      return;
+    if (b == 4)
+    {
+      __ambiguous();
+      b = 0;
+    }
+    word_ |= __storage_type(b) << shift_;
+    ++n_;
+    if ((shift_ += 2) == bits_per_word)
+    {
+      __store(n_ / base_vector::bases_per_word - 1);
+      word_ = 0;
+      shift_ = 0;
+    }
+  }
+
+  void push(const char* first, const char* last)
+  {
+    // whole words' worth of plain ACGT go in one shift and merge
+    while (last - first >= base_vector::bases_per_word)
+    {
+      __storage_type w = 0;
+      unsigned char bad = 0;
+      for (unsigned i = 0; i != base_vector::bases_per_word; ++i)
+      {
+        unsigned char b = __ascii_to_base[static_cast<unsigned char>(first[i])];
+        bad |= b;
+        w |= __storage_type(b & 3) << (2 * i);
+      }
+      if (bad & 4)
+        break;
+      first += base_vector::bases_per_word;
+      const size_type i = n_ / base_vector::bases_per_word;
+      n_ += base_vector::bases_per_word;
+      word_ |= w << shift_;
+      __store(i);
+      word_ = shift_ == 0 ? 0 : w >> (bits_per_word - shift_);
+    }
+    for (; first != last; ++first)
+      push(static_cast<unsigned char>(*first));
+  }
+
+  void finish()
+  {
+    if (shift_ != 0)
+      __store(n_ / base_vector::bases_per_word);
+    seq_.resize(n_);
+  }
+};
+
+//  Reads FASTA and FASTQ records from a stream in fixed-size blocks.
+//  Sequence lines are packed straight from the block into the record's
+//  base_vector; multi-line sequences and CRLF line ends are accepted.
+class sequence_reader
+{
+ public:
+  static constexpr std::size_t default_block_size = 1 << 20;
+
+  explicit sequence_reader(std::istream& is, std::size_t block_size = default_block_size)
+    : is_(is),
+      buf_(new char[block_size]),
+      cap_(block_size),
+      pos_(0),
+      end_(0)
+  {}
+
+  bool read(sequence_record& r);
+
+ private:
+  std::istream& is_;
+  std::unique_ptr<char[]> buf_;
+  std::size_t cap_;
+  std::size_t pos_;
+  std::size_t end_;
+
+  [[noreturn]] static void __throw_format_error(const char* what)
+  {throw std::runtime_error(std::string("sequence_reader: ") + what);}
+
+  //  Makes sure there is unread input in the block, false at end of input.
+  bool __fill()
+  {
+    if (pos_ != end_)
+      return true;
+    is_.read(buf_.get(), static_cast<std::streamsize>(cap_));
+    pos_ = 0;
+    end_ = static_cast<std::size_t>(is_.gcount());
+    return end_ != 0;
+  }
+
+  //  Calls f(first, last) on the pieces of the rest of the current line
+  //  and consumes its line end.
+  template <class F>
+  void __scan_line(F f)
+  {
+    while (__fill())
+    {
+      const char* first = buf_.get() + pos_;
+      const char* last = buf_.get() + end_;
+      const char* nl = static_cast<const char*>(std::memchr(first, '\n', last - first));
+      f(first, nl ? nl : last);
+      pos_ = (nl ? nl + 1 : last) - buf_.get();
+      if (nl)
+        return;
+    }
+  }
+
+  void __read_line(std::string& s)
+  {
+    s.clear();
+    __scan_line([&s](const char* first, const char* last) {s.append(first, last);});
+    if (!s.empty() && s.back() == '\r')
+      s.pop_back();
+  }
+};
+
+bool sequence_reader::read(sequence_record& r)
+{
+  r.name.clear();
+  r.seq.clear();
+  r.qual.clear();
+  r.ambiguous.clear();
+
+  // skip blank lines between records
+  while (__fill() && (buf_[pos_] == '\n' || buf_[pos_] == '\r'))
+    ++pos_;
+  if (!__fill())
+    return false;
+
+  const char marker = buf_[pos_++];
+  if (marker != '>' && marker != '@')
+    __throw_format_error("expected '>' or '@' at the start of a record");
+  __read_line(r.name);
+
+  __base_packer packer(r.seq, r.ambiguous);
+  auto pack = [&packer](const char* first, const char* last) {packer.push(first, last);};
+  // a sequence runs until the next record (FASTA) or the '+' line (FASTQ)
+  const char stop = marker == '>' ? '>' : '+';
+  while (__fill() && buf_[pos_] != stop)
+    __scan_line(pack);
+  packer.finish();
+
+  if (marker == '@')
+  {
+    if (!__fill())
+      __throw_format_error("missing '+' line");
+    __scan_line([](const char*, const char*) {});
+    while (r.qual.size() < r.seq.size() && __fill())
+      __scan_line([&r](const char* first, const char* last)
+      {
+        for (; first != last; ++first)
+          if (static_cast<unsigned char>(*first) > ' ')
+            r.qual.push_back(*first);
+      });
+    if (r.qual.size() != r.seq.size())
+      __throw_format_error("quality length differs from sequence length");
+  }
+  return true;
+}
+
+}
+
+#endif //BIOVOLTRON_SEQUENCE_READER
@@ -0,0 +1,540 @@
+#ifndef BIOVOLTRON_SMALL_BASE_VECTOR
+#define BIOVOLTRON_SMALL_BASE_VECTOR
+
+#include <cstddef>
+#include <climits>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include "base_vector.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+template <std::size_t N>  // inline capacity in bases, rounded up to whole storage words
+class small_base_vector
+{
+ public:
+  typedef unsigned char                            value_type;
+  typedef std::allocator<value_type>               allocator_type;
+  typedef implementation-defined                   reference;        // as base_vector's
+  typedef implementation-defined                   const_reference;
+  typedef implementation-defined                   iterator;
+  typedef implementation-defined                   const_iterator;
+  typedef std::size_t                              size_type;
+  typedef std::ptrdiff_t                           difference_type;
+  typedef std::reverse_iterator<iterator>          reverse_iterator;
+  typedef std::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+  static constexpr size_type inline_capacity;
+
+  small_base_vector() noexcept;
+  explicit small_base_vector(size_type n);
+  small_base_vector(size_type n, const value_type& x);
+  small_base_vector(std::input_iterator auto first, std::input_iterator auto last);
+  small_base_vector(std::forward_iterator auto first, std::forward_iterator auto last);
+  small_base_vector(const small_base_vector& v);
+  small_base_vector(small_base_vector&& v) noexcept;
+  small_base_vector(initializer_list<value_type> il);
+  ~small_base_vector();
+  small_base_vector& operator=(const small_base_vector& v);
+  small_base_vector& operator=(small_base_vector&& v) noexcept;
+  small_base_vector& operator=(initializer_list<value_type> il);
+  void assign(std::input_iterator auto first, std::input_iterator auto last);
+  void assign(std::forward_iterator auto first, std::forward_iterator auto last);
+  void assign(size_type n, const value_type& x);
+  void assign(initializer_list<value_type> il);
+
+  iterator               begin() noexcept;
+  const_iterator         begin()   const noexcept;
+  iterator               end() noexcept;
+  const_iterator         end()     const noexcept;
+  reverse_iterator       rbegin() noexcept;
+  const_reverse_iterator rbegin()  const noexcept;
+  reverse_iterator       rend() noexcept;
+  const_reverse_iterator rend()    const noexcept;
+  const_iterator         cbegin()  const noexcept;
+  const_iterator         cend()    const noexcept;
+  const_reverse_iterator crbegin() const noexcept;
+  const_reverse_iterator crend()   const noexcept;
+
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+  size_type capacity() const noexcept;
+  bool empty() const noexcept;
+  bool is_inline() const noexcept;   // storage is inside the object
+  void reserve(size_type n);
+  void shrink_to_fit() noexcept;     // moves back inline when it fits
+
+  reference       operator[](size_type n);
+  const_reference operator[](size_type n) const;
+  reference       at(size_type n);
+  const_reference at(size_type n) const;
+  reference       front();
+  const_reference front() const;
+  reference       back();
+  const_reference back() const;
+  storage_pointer       data() noexcept;
+  const_storage_pointer data() const noexcept;
+
+  void push_back(const value_type& x);
+  template <class... Args> reference emplace_back(Args&&... args);
+  void pop_back();
+
+  iterator insert(const_iterator position, const value_type& x);
+  iterator insert(const_iterator position, size_type n, const value_type& x);
+  iterator insert(const_iterator position, std::input_iterator auto first, std::input_iterator auto last);
+  iterator insert(const_iterator position, initializer_list<value_type> il);
+
+  iterator erase(const_iterator position);
+  iterator erase(const_iterator first, const_iterator last);
+
+  void clear() noexcept;
+
+  void resize(size_type sz, value_type x = 0);
+  void swap(small_base_vector&) noexcept;
+  void flip() noexcept;
+  size_type count(value_type x) const noexcept;
+  std::array<size_type, 4> histogram() const noexcept;
+
+  bool __invariants() const;
+};
+
+template <std::size_t N> bool operator== (const small_base_vector<N>& x, const small_base_vector<N>& y);
+template <std::size_t N> auto operator<=>(const small_base_vector<N>& x, const small_base_vector<N>& y);
+template <std::size_t N> void swap(small_base_vector<N>& x, small_base_vector<N>& y) noexcept;
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+//  A base_vector that keeps up to N bases in the object itself and only
+//  goes to the allocator beyond that. Iterators, references and the word
+//  algorithms are base_vector's, instantiated for this container; moving
+//  or swapping an inline vector copies its words and invalidates iterators.
+template <std::size_t N>
+class small_base_vector
+{
+ public:
+  typedef small_base_vector                        __self;
+  typedef unsigned char                            value_type;
+  typedef std::allocator<value_type>               allocator_type;
+  typedef std::size_t                              size_type;
+  typedef std::ptrdiff_t                           difference_type;
+  typedef size_type                                __storage_type;
+  typedef base_iterator<small_base_vector, false>  pointer;
+  typedef base_iterator<small_base_vector, true>   const_pointer;
+  typedef pointer                                  iterator;
+  typedef const_pointer                            const_iterator;
+  typedef std::reverse_iterator<iterator>          reverse_iterator;
+  typedef std::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+  static constexpr unsigned bases_per_word = static_cast<unsigned>(sizeof(__storage_type) * CHAR_BIT / 2);
+  static constexpr size_type inline_capacity = (N + bases_per_word - 1) / bases_per_word * bases_per_word;
+  static_assert(N > 0, "use base_vector for no inline capacity");
+ private:
+  typedef std::allocator<__storage_type>             __storage_allocator;
+  typedef std::allocator_traits<__storage_allocator> __storage_traits;
+  typedef __storage_type*                            __storage_pointer;
+  typedef const __storage_type*                      __const_storage_pointer;
+
+  static constexpr size_type __inline_words = inline_capacity / bases_per_word;
+
+  __storage_pointer begin_;
+  size_type         size_;
+  size_type         cap_;  // in words
+  __storage_type    buf_[__inline_words];
+ public:
+  typedef base_reference      <small_base_vector> reference;
+  typedef base_const_reference<small_base_vector> const_reference;
+ private:
+  static size_type __words(size_type n) noexcept {return (n + bases_per_word - 1) / bases_per_word;}
+  static size_type __align_it(size_type n) noexcept {return __words(n) * bases_per_word;}
+
+  [[noreturn]] static void __throw_length_error() {throw std::length_error("small_base_vector");}
+  [[noreturn]] static void __throw_out_of_range() {throw std::out_of_range("small_base_vector");}
+
+  //  Moves the content to a fresh heap block of nw words.
+  //  Precondition:  nw >= __words(size())
+  void __reallocate(size_type nw)
+  {
+    __storage_allocator a;
+    __storage_pointer p = __storage_traits::allocate(a, nw);
+    std::copy_n(begin_, __words(size_), p);
+    __release();
+    begin_ = p;
+    cap_ = nw;
+  }
+
+  //  Frees a heap block, leaving the (unchanged) size on the inline buffer.
+  void __release() noexcept
+  {
+    if (begin_ != buf_)
+    {
+      __storage_allocator a;
+      __storage_traits::deallocate(a, begin_, cap_);
+      begin_ = buf_;
+      cap_ = __inline_words;
+    }
+  }
+
+  //  Takes v's storage, copying it if it is inline, and leaves v empty.
+  //  Precondition:  *this holds no heap block
+  void __steal(small_base_vector& v) noexcept
+  {
+    if (v.begin_ == v.buf_)
+      std::copy_n(v.buf_, __words(v.size_), buf_);
+    else
+    {
+      begin_ = v.begin_;
+      cap_ = v.cap_;
+      v.begin_ = v.buf_;
+      v.cap_ = __inline_words;
+    }
+    size_ = v.size_;
+    v.size_ = 0;
+  }
+
+  //  Precondition:  new_size > capacity()
+  size_type __recommend(size_type new_size) const
+  {
+    const size_type ms = max_size();
+    if (new_size > ms)
+      __throw_length_error();
+    const size_type cap = capacity();
+    if (cap >= ms / 2)
+      return ms;
+    return std::max(2 * cap, __align_it(new_size));
+  }
+
+  void __grow_by(size_type n)
+  {
+    if (n > capacity() - size_)
+      __reallocate(__words(__recommend(size_ + n)));
+  }
+
+  reference       __make_ref (size_type pos)       noexcept {return reference      (begin_ + pos / bases_per_word, pos % bases_per_word);}
+  const_reference __make_ref (size_type pos) const noexcept {return const_reference(begin_ + pos / bases_per_word, pos % bases_per_word);}
+  iterator        __make_iter(size_type pos)       noexcept {return iterator       (begin_ + pos / bases_per_word, pos % bases_per_word);}
+  const_iterator  __make_iter(size_type pos) const noexcept {return const_iterator (begin_ + pos / bases_per_word, pos % bases_per_word);}
+
+ public:
+  small_base_vector() noexcept : begin_(buf_), size_(0), cap_(__inline_words) {}
+  explicit small_base_vector(size_type n) : small_base_vector() {resize(n);}
+  small_base_vector(size_type n, const value_type& x) : small_base_vector() {resize(n, x);}
+
+  small_base_vector(std::input_iterator auto first, std::input_iterator auto last) : small_base_vector()
+  {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  small_base_vector(std::forward_iterator auto first, std::forward_iterator auto last) : small_base_vector()
+  {assign(first, last);}
+
+  small_base_vector(std::initializer_list<value_type> il) : small_base_vector() {assign(il.begin(), il.end());}
+
+  small_base_vector(const small_base_vector& v) : small_base_vector()
+  {
+    if (v.size_ > capacity())
+      __reallocate(__words(v.size_));
+    std::copy_n(v.begin_, __words(v.size_), begin_);
+    size_ = v.size_;
+  }
+
+  small_base_vector(small_base_vector&& v) noexcept : small_base_vector() {__steal(v);}
+
+  ~small_base_vector() {__release();}
+
+  small_base_vector& operator=(const small_base_vector& v)
+  {
+    if (this != &v)
+    {
+      if (v.size_ > capacity())
+      {
+        size_ = 0;
+        __reallocate(__words(v.size_));
+      }
+      std::copy_n(v.begin_, __words(v.size_), begin_);
+      size_ = v.size_;
+    }
+    return *this;
+  }
+
+  small_base_vector& operator=(small_base_vector&& v) noexcept
+  {
+    if (this != &v)
+    {
+      __release();
+      __steal(v);
+    }
+    return *this;
+  }
+
+  small_base_vector& operator=(std::initializer_list<value_type> il)
+  {assign(il.begin(), il.end()); return *this;}
+
+  void assign(std::input_iterator auto first, std::input_iterator auto last)
+  {
+    clear();
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  void assign(std::forward_iterator auto first, std::forward_iterator auto last)
+  {
+    clear();
+    difference_type ns = std::distance(first, last);
+    assert(ns >= 0 && "invalid range specified");
+    const auto n = static_cast<size_type>(ns);
+    if (n > capacity())
+      __reallocate(__words(n));
+    size_ = n;
+    using std::copy;
+    copy(first, last, begin());
+  }
+
+  void assign(size_type n, const value_type& x)
+  {
+    clear();
+    resize(n, x);
+  }
+
+  void assign(std::initializer_list<value_type> il) {assign(il.begin(), il.end());}
+
+  allocator_type get_allocator() const noexcept {return allocator_type();}
+
+  size_type max_size() const noexcept {return std::numeric_limits<size_type>::max() / 2;}
+  size_type capacity() const noexcept {return cap_ * bases_per_word;}
+  size_type size() const noexcept {return size_;}
+  bool empty() const noexcept {return size_ == 0;}
+  bool is_inline() const noexcept {return begin_ == buf_;}
+
+  void reserve(size_type n)
+  {
+    if (n > capacity())
+    {
+      if (n > max_size())
+        __throw_length_error();
+      __reallocate(__words(n));
+    }
+  }
+
+  void shrink_to_fit() noexcept
+  {
+    if (is_inline())
+      return;
+    const size_type nw = __words(size_);
+    if (nw <= __inline_words)
+    {
+      __storage_pointer p = begin_;
+      const size_type cap = cap_;
+      std::copy_n(p, nw, buf_);
+      begin_ = buf_;
+      cap_ = __inline_words;
+      __storage_allocator a;
+      __storage_traits::deallocate(a, p, cap);
+    }
+    else if (nw < cap_)
+    {
+      try
+      {
+        __reallocate(nw);
+      }
+      catch (...)
+      {
+      }
+    }
+  }
+
+  iterator                 begin()       noexcept {return __make_iter(0);}
+  const_iterator           begin() const noexcept {return __make_iter(0);}
+  iterator                   end()       noexcept {return __make_iter(size_);}
+  const_iterator             end() const noexcept {return __make_iter(size_);}
+  reverse_iterator        rbegin()       noexcept {return reverse_iterator(end());}
+  const_reverse_iterator  rbegin() const noexcept {return const_reverse_iterator(end());}
+  reverse_iterator          rend()       noexcept {return reverse_iterator(begin());}
+  const_reverse_iterator    rend() const noexcept {return const_reverse_iterator(begin());}
+  const_iterator          cbegin() const noexcept {return __make_iter(0);}
+  const_iterator            cend() const noexcept {return __make_iter(size_);}
+  const_reverse_iterator crbegin() const noexcept {return rbegin();}
+  const_reverse_iterator   crend() const noexcept {return rend();}
+
+  reference       operator[](size_type n)       {return __make_ref(n);}
+  const_reference operator[](size_type n) const {return __make_ref(n);}
+
+  reference at(size_type n)
+  {
+    if (n >= size_)
+      __throw_out_of_range();
+    return (*this)[n];
+  }
+
+  const_reference at(size_type n) const
+  {
+    if (n >= size_)
+      __throw_out_of_range();
+    return (*this)[n];
+  }
+
+  reference       front()       {return __make_ref(0);}
+  const_reference front() const {return __make_ref(0);}
+  reference       back()        {return __make_ref(size_ - 1);}
+  const_reference back()  const {return __make_ref(size_ - 1);}
+
+  __storage_pointer       data()       noexcept {return begin_;}
+  __const_storage_pointer data() const noexcept {return begin_;}
+
+  void push_back(const value_type& x)
+  {
+    __grow_by(1);
+    ++size_;
+    back() = x;
+  }
+
+  template <class... Args>
+  reference emplace_back(Args&&... args)
+  {
+    push_back(value_type(std::forward<Args>(args)...));
+    return back();
+  }
+
+  void pop_back() {--size_;}
+
+  template <class... Args>
+  iterator emplace(const_iterator position, Args&&... args)
+  {return insert(position, value_type(std::forward<Args>(args)...));}
+
+  iterator insert(const_iterator position, const value_type& x) {return insert(position, 1, x);}
+
+  iterator insert(const_iterator position, size_type n, const value_type& x)
+  {
+    const difference_type off = position - cbegin();
+    __grow_by(n);
+    const_iterator old_end = cend();
+    size_ += n;
+    biovoltron::copy_backward(cbegin() + off, old_end, end());
+    biovoltron::fill_n(begin() + off, n, x);
+    return begin() + off;
+  }
+
+  iterator insert(const_iterator position, std::input_iterator auto first, std::input_iterator auto last)
+  {
+    small_base_vector v(first, last);
+    return insert(position, v.begin(), v.end());
+  }
+
+  iterator insert(const_iterator position, std::forward_iterator auto first, std::forward_iterator auto last)
+  {
+    const difference_type off = position - cbegin();
+    const difference_type n_signed = std::distance(first, last);
+    assert(n_signed >= 0 && "invalid range specified");
+    const auto n = static_cast<size_type>(n_signed);
+    __grow_by(n);
+    const_iterator old_end = cend();
+    size_ += n;
+    biovoltron::copy_backward(cbegin() + off, old_end, end());
+    using std::copy;
+    copy(first, last, begin() + off);
+    return begin() + off;
+  }
+
+  iterator insert(const_iterator position, std::initializer_list<value_type> il)
+  {return insert(position, il.begin(), il.end());}
+
+  iterator erase(const_iterator position) {return erase(position, position + 1);}
+
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const difference_type off = first - cbegin();
+    biovoltron::copy(last, cend(), begin() + off);
+    size_ -= last - first;
+    return begin() + off;
+  }
+
+  void clear() noexcept {size_ = 0;}
+
+  void resize(size_type sz, value_type x = 0)
+  {
+    if (sz > size_)
+    {
+      const size_type n = sz - size_;
+      __grow_by(n);
+      const size_type old_size = size_;
+      size_ = sz;
+      biovoltron::fill_n(__make_iter(old_size), n, x);
+    }
+    else
+      size_ = sz;
+  }
+
+  void swap(small_base_vector& x) noexcept
+  {
+    if (!is_inline() && !x.is_inline())
+    {
+      std::swap(begin_, x.begin_);
+      std::swap(size_, x.size_);
+      std::swap(cap_, x.cap_);
+    }
+    else if (this != &x)
+    {
+      small_base_vector t(std::move(x));
+      x = std::move(*this);
+      *this = std::move(t);
+    }
+  }
+
+  static void swap(reference x, reference y) noexcept {biovoltron::swap(x, y);}
+
+  void flip() noexcept
+  {
+    const size_type nw = __words(size_);
+    for (size_type i = 0; i != nw; ++i)
+      begin_[i] = ~begin_[i];
+  }
+
+  size_type count(value_type x) const noexcept {return biovoltron::count(begin(), end(), x);}
+  std::array<size_type, 4> histogram() const noexcept {return biovoltron::histogram(begin(), end());}
+
+  bool __invariants() const
+  {
+    if (is_inline())
+      return cap_ == __inline_words && size_ <= capacity();
+    return cap_ > __inline_words && size_ <= capacity();
+  }
+
+ private:
+  friend class base_reference<small_base_vector>;
+  friend class base_const_reference<small_base_vector>;
+  friend class base_iterator<small_base_vector, false>;
+  friend class base_iterator<small_base_vector, true>;
+};
+
+template <std::size_t N>
+bool operator==(const small_base_vector<N>& x, const small_base_vector<N>& y)
+{return x.size() == y.size() && biovoltron::equal(x.begin(), x.end(), y.begin());}
+
+template <std::size_t N>
+auto operator<=>(const small_base_vector<N>& x, const small_base_vector<N>& y)
+{
+  auto [i, j] = biovoltron::mismatch(x.begin(), x.end(), y.begin(), y.end());
+  if (i == x.end() || j == y.end())
+    return x.size() <=> y.size();
+  return static_cast<unsigned char>(*i) <=> static_cast<unsigned char>(*j);
+}
+
+template <std::size_t N>
+void swap(small_base_vector<N>& x, small_base_vector<N>& y) noexcept {x.swap(y);}
+
+}
+
+#endif //BIOVOLTRON_SMALL_BASE_VECTOR
@@ -0,0 +1,257 @@
+#ifndef BIOVOLTRON_SUFFIX_ARRAY
+#define BIOVOLTRON_SUFFIX_ARRAY
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <cerrno>
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "base_vector.hpp"
+
+/*
+
+Suffix arrays by induced sorting (SA-IS). The first level reads bases
+straight from the packed words, so the only memory besides the output is
+one bit per base for the suffix types. A suffix that is a prefix of another
+sorts first. Index is std::uint32_t or std::uint64_t (or std::size_t) and
+must be able to hold text.size().
+
+namespace biovoltron
+{
+
+template <class Index = std::size_t, class Container>  // base_vector, small_base_vector<N> or vector<uint2_t>
+  std::vector<Index> suffix_array(const Container& text);
+template <class Index, class Container>
+  void suffix_array(const Container& text, Index* sa);               // sa has text.size() entries
+template <class Index, class Container>
+  void suffix_array(const Container& text, const std::string& path);  // text.size() Index values, native order
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+//  Symbol i of a packed text.
+template <class StorageType>
+struct __packed_text
+{
+  static constexpr unsigned bases_per_word = sizeof(StorageType) * CHAR_BIT / 2;
+  const StorageType* w;
+
+  unsigned operator()(std::size_t i) const noexcept
+  {return w[i / bases_per_word] >> (i % bases_per_word * 2) & 3;}
+};
+
+//  Symbol i of a reduced text.
+template <class Index>
+struct __index_text
+{
+  const Index* s;
+
+  Index operator()(std::size_t i) const noexcept {return s[i];}
+};
+
+//  Sorts the suffixes of the n symbols of t, drawn from [0, cnt.size()) with
+//  cnt[c] occurrences of c, into sa. The text ends in a virtual sentinel
+//  smaller than every symbol. Each reduced problem lives in sa itself: the
+//  names of the LMS substrings at its back, their suffix array at its front.
+template <class Index, class Text>
+void __sais(const Text& t, Index* sa, Index n, const std::vector<Index>& cnt)
+{
+  constexpr Index empty = std::numeric_limits<Index>::max();
+  if (n == 0)
+    return;
+  if (n == 1)
+  {
+    sa[0] = 0;
+    return;
+  }
+  const Index k = static_cast<Index>(cnt.size());
+  std::vector<Index> bkt(k);
+  auto heads = [&]
+  {
+    Index s = 0;
+    for (Index c = 0; c != k; ++c)
+    {
+      bkt[c] = s;
+      s += cnt[c];
+    }
+  };
+  auto tails = [&]
+  {
+    Index s = 0;
+    for (Index c = 0; c != k; ++c)
+    {
+      s += cnt[c];
+      bkt[c] = s;
+    }
+  };
+
+  // S-type suffixes are smaller than the suffix after them
+  std::vector<bool> stype(n);
+  for (Index i = n - 1; i-- != 0;)
+  {
+    const auto a = t(i), b = t(i + 1);
+    stype[i] = a < b || (a == b && stype[i + 1]);
+  }
+  auto lms = [&](Index i) {return i != 0 && stype[i] && !stype[i - 1];};
+
+  auto induce = [&]
+  {
+    heads();
+    sa[bkt[t(n - 1)]++] = n - 1;  // the suffix before the sentinel
+    for (Index i = 0; i != n; ++i)
+      if (sa[i] != empty && sa[i] != 0 && !stype[sa[i] - 1])
+        sa[bkt[t(sa[i] - 1)]++] = sa[i] - 1;
+    tails();
+    for (Index i = n; i-- != 0;)
+      if (sa[i] != empty && sa[i] != 0 && stype[sa[i] - 1])
+        sa[--bkt[t(sa[i] - 1)]] = sa[i] - 1;
+  };
+
+  // sort the LMS substrings
+  std::fill(sa, sa + n, empty);
+  tails();
+  for (Index i = 1; i != n; ++i)
+    if (lms(i))
+      sa[--bkt[t(i)]] = i;
+  induce();
+
+  Index n1 = 0;
+  for (Index i = 0; i != n; ++i)
+    if (lms(sa[i]))
+      sa[n1++] = sa[i];
+
+  // name them; equal substrings get equal names
+  std::fill(sa + n1, sa + n, empty);
+  Index names = 0, prev = empty;
+  for (Index i = 0; i != n1; ++i)
+  {
+    const Index pos = sa[i];
+    bool diff = prev == empty;
+    for (Index d = 0; !diff; ++d)
+    {
+      if (pos + d == n || prev + d == n || t(pos + d) != t(prev + d) || stype[pos + d] != stype[prev + d])
+        diff = true;
+      else if (d != 0 && (lms(pos + d) || lms(prev + d)))
+        break;
+    }
+    if (diff)
+    {
+      ++names;
+      prev = pos;
+    }
+    sa[n1 + pos / 2] = names - 1;
+  }
+  for (Index i = n, j = n; i-- != n1;)
+    if (sa[i] != empty)
+      sa[--j] = sa[i];
+
+  // sort the reduced text
+  Index* s1 = sa + (n - n1);
+  if (names < n1)
+  {
+    std::vector<Index> cnt1(names);
+    for (Index i = 0; i != n1; ++i)
+      ++cnt1[s1[i]];
+    __sais(__index_text<Index>{s1}, sa, n1, cnt1);
+  }
+  else
+    for (Index i = 0; i != n1; ++i)
+      sa[s1[i]] = i;
+
+  // put the sorted LMS suffixes at their bucket ends and induce the rest
+  for (Index i = 1, j = 0; i != n; ++i)
+    if (lms(i))
+      s1[j++] = i;
+  for (Index i = 0; i != n1; ++i)
+    sa[i] = s1[sa[i]];
+  std::fill(sa + n1, sa + n, empty);
+  tails();
+  for (Index i = n1; i-- != 0;)
+  {
+    const Index j = sa[i];
+    sa[i] = empty;
+    sa[--bkt[t(j)]] = j;
+  }
+  induce();
+}
+
+template <class Index, class Container>
+void suffix_array(const Container& text, Index* sa)
+{
+  typedef std::remove_cvref_t<decltype(*std::to_address(text.data()))> __storage_type;
+  if (text.size() >= std::numeric_limits<Index>::max())
+    throw std::length_error("suffix_array: text too long for the index type");
+  // the word-level histogram of base_vector.hpp or uint2_t.hpp, found by argument lookup
+  const auto hist = histogram(text.begin(), text.end());
+  const std::vector<Index> cnt(hist.begin(), hist.end());
+  __sais(__packed_text<__storage_type>{std::to_address(text.data())}, sa, static_cast<Index>(text.size()), cnt);
+}
+
+template <class Index = std::size_t, class Container>
+std::vector<Index> suffix_array(const Container& text)
+{
+  std::vector<Index> sa(text.size());
+  suffix_array(text, sa.data());
+  return sa;
+}
+
+//  Builds the suffix array in a file mapped into memory, so the kernel can
+//  page it out when it does not fit in RAM.
+template <class Index, class Container>
+void suffix_array(const Container& text, const std::string& path)
+{
+  auto fail = [&](const std::string& what)
+  {throw std::system_error(errno, std::generic_category(), "suffix_array: " + what + " " + path);};
+  const std::size_t bytes = text.size() * sizeof(Index);
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    fail("cannot open");
+  if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+  {
+    const int e = errno;
+    ::close(fd);
+    errno = e;
+    fail("cannot resize");
+  }
+  if (bytes == 0)
+  {
+    ::close(fd);
+    return;
+  }
+  void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int e = errno;
+  ::close(fd);
+  if (p == MAP_FAILED)
+  {
+    errno = e;
+    fail("cannot map");
+  }
+  try
+  {
+    suffix_array(text, static_cast<Index*>(p));
+  }
+  catch (...)
+  {
+    ::munmap(p, bytes);
+    throw;
+  }
+  ::munmap(p, bytes);
+}
+
+}
+
+#endif //BIOVOLTRON_SUFFIX_ARRAY
@@ -0,0 +1,418 @@
+#ifndef BIOVOLTRON_TWOBIT
+#define BIOVOLTRON_TWOBIT
+
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <limits>
+#include <charconv>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <stdexcept>
+#include "base_vector.hpp"
+
+/*
+
+namespace biovoltron
+{
+
+struct twobit_sequence
+{
+  std::string name;
+  base_vector seq;                                               // bases under N blocks read as T
+  std::vector<std::pair<std::size_t, std::size_t>> n_blocks;     // [first, last) runs of N
+  std::vector<std::pair<std::size_t, std::size_t>> mask_blocks;  // [first, last) soft-masked runs
+};
+
+class twobit_reader
+{
+ public:
+  typedef std::size_t size_type;
+
+  explicit twobit_reader(const std::string& path);  // reads the header and index only
+
+  size_type size() const noexcept;                  // number of sequences
+  const std::string& name(size_type i) const;
+  size_type length(std::string_view name);
+
+  twobit_sequence read(std::string_view name);
+  twobit_sequence fetch(std::string_view name, size_type first, size_type last);  // [first, last), 0-based
+  twobit_sequence fetch(std::string_view region);   // "chr", "chr:start" or "chr:start-end", 1-based inclusive
+};
+
+void write_twobit(std::ostream& os, const std::vector<twobit_sequence>& seqs);
+void write_twobit(const std::string& path, const std::vector<twobit_sequence>& seqs);
+
+}  // biovoltron
+
+*/
+
+namespace biovoltron
+{
+
+struct twobit_sequence
+{
+  std::string name;
+  base_vector seq;
+  std::vector<std::pair<std::size_t, std::size_t>> n_blocks;
+  std::vector<std::pair<std::size_t, std::size_t>> mask_blocks;
+};
+
+//  .2bit packs four bases per byte, first base in the high bits, coded
+//  T=0 C=1 A=2 G=3. The conversions below work on a whole storage word of
+//  such bytes, loaded so that byte k lands in bits [8k, 8k+8): reversing
+//  the slots of every byte gives base_vector's order, and the codes map
+//  bitwise with hi' = ~(lo ^ hi), lo' = ~hi (and back with hi = ~lo',
+//  lo = lo' ^ hi').
+template <class T>
+inline T __twobit_to_word(T w) noexcept
+{
+  constexpr T m1 = ~T(0) / 3, m2 = ~T(0) / 5, m4 = ~T(0) / 17;
+  w = (w >> 4 & m4) | (w & m4) << 4;
+  w = (w >> 2 & m2) | (w & m2) << 2;
+  const T lo = w & m1, hi = w >> 1 & m1;
+  return (~hi & m1) | (~(lo ^ hi) & m1) << 1;
+}
+
+template <class T>
+inline T __word_to_twobit(T w) noexcept
+{
+  constexpr T m1 = ~T(0) / 3, m2 = ~T(0) / 5, m4 = ~T(0) / 17;
+  const T lo = w & m1, hi = w >> 1 & m1;
+  w = (lo ^ hi) | (~lo & m1) << 1;
+  w = (w >> 2 & m2) | (w & m2) << 2;
+  w = (w >> 4 & m4) | (w & m4) << 4;
+  return w;
+}
+
+//  Little-endian load of up to sizeof(T) bytes, zero filled.
+template <class T>
+inline T __load_bytes(const unsigned char* p, std::size_t n) noexcept
+{
+  T w = 0;
+  for (std::size_t k = 0; k != n; ++k)
+    w |= T(p[k]) << (CHAR_BIT * k);
+  return w;
+}
+
+template <class T>
+inline T __byteswap(T x) noexcept
+{
+  T y = 0;
+  for (std::size_t k = 0; k != sizeof(T); ++k, x >>= CHAR_BIT)
+    y = y << CHAR_BIT | (x & 0xFF);
+  return y;
+}
+
+inline constexpr std::uint32_t __twobit_signature = 0x1A412743;
+
+class twobit_reader
+{
+ public:
+  typedef std::size_t size_type;
+ private:
+  typedef base_vector::__storage_type __storage_type;
+  typedef std::vector<std::pair<size_type, size_type>> __blocks;
+
+  struct __entry
+  {
+    std::string   name;
+    std::uint64_t offset;
+    bool          loaded = false;
+    std::uint64_t dna_offset = 0;
+    size_type     dna_size = 0;
+    __blocks      n_blocks;
+    __blocks      mask_blocks;
+  };
+
+  std::ifstream is_;
+  bool swap_ = false;
+  std::vector<__entry> index_;
+  std::map<std::string, size_type, std::less<>> by_name_;
+
+  [[noreturn]] static void __throw_format_error(const std::string& what)
+  {throw std::runtime_error("twobit_reader: " + what);}
+
+  void __read(void* p, std::size_t n)
+  {
+    if (!is_.read(static_cast<char*>(p), static_cast<std::streamsize>(n)))
+      __throw_format_error("unexpected end of file");
+  }
+
+  std::uint32_t __read_u32()
+  {
+    std::uint32_t x;
+    __read(&x, sizeof(x));
+    return swap_ ? __byteswap(x) : x;
+  }
+
+  std::uint64_t __read_u64()
+  {
+    std::uint64_t x;
+    __read(&x, sizeof(x));
+    return swap_ ? __byteswap(x) : x;
+  }
+
+  void __read_blocks(__blocks& b)
+  {
+    const std::uint32_t n = __read_u32();
+    b.resize(n);
+    for (auto& [first, last] : b)
+      first = __read_u32();
+    for (auto& [first, last] : b)
+      last = first + __read_u32();
+  }
+
+  __entry& __find(std::string_view name);
+
+  //  Appends the blocks of b overlapping [first, last), clipped and made
+  //  relative to first; an empty region overlaps nothing.
+  static void __clip(const __blocks& b, size_type first, size_type last, __blocks& out)
+  {
+    auto it = std::upper_bound(b.begin(), b.end(), first,
+                               [](size_type x, const auto& blk) {return x < blk.second;});
+    for (; it != b.end() && it->first < last; ++it)
+    {
+      const size_type lo = std::max(it->first, first), hi = std::min(it->second, last);
+      if (lo < hi)
+        out.emplace_back(lo - first, hi - first);
+    }
+  }
+
+ public:
+  explicit twobit_reader(const std::string& path);
+
+  size_type size() const noexcept {return index_.size();}
+  const std::string& name(size_type i) const {return index_.at(i).name;}
+  size_type length(std::string_view name) {return __find(name).dna_size;}
+
+  twobit_sequence read(std::string_view name) {return fetch(name, 0, length(name));}
+  twobit_sequence fetch(std::string_view name, size_type first, size_type last);
+  twobit_sequence fetch(std::string_view region);
+};
+
+twobit_reader::twobit_reader(const std::string& path) : is_(path, std::ios::binary)
+{
+  if (!is_)
+    __throw_format_error("cannot open " + path);
+  std::uint32_t sig = __read_u32();
+  if (sig != __twobit_signature)
+  {
+    if (__byteswap(sig) != __twobit_signature)
+      __throw_format_error(path + " is not a .2bit file");
+    swap_ = true;
+  }
+  const std::uint32_t version = __read_u32();
+  if (version > 1)
+    __throw_format_error("unsupported .2bit version " + std::to_string(version));
+  const std::uint32_t count = __read_u32();
+  __read_u32();
+
+  index_.resize(count);
+  for (size_type i = 0; i != count; ++i)
+  {
+    unsigned char n;
+    __read(&n, 1);
+    index_[i].name.resize(n);
+    __read(index_[i].name.data(), n);
+    index_[i].offset = version == 0 ? __read_u32() : __read_u64();
+    by_name_.emplace(index_[i].name, i);
+  }
+}
+
+typename twobit_reader::__entry& twobit_reader::__find(std::string_view name)
+{
+  auto it = by_name_.find(name);
+  if (it == by_name_.end())
+    throw std::out_of_range("twobit_reader: no sequence " + std::string(name));
+  __entry& e = index_[it->second];
+  if (!e.loaded)
+  {
+    is_.seekg(static_cast<std::streamoff>(e.offset));
+    e.dna_size = __read_u32();
+    __read_blocks(e.n_blocks);
+    __read_blocks(e.mask_blocks);
+    __read_u32();
+    e.dna_offset = static_cast<std::uint64_t>(is_.tellg());
+    e.loaded = true;
+  }
+  return e;
+}
+
+//  Reads only the bytes covering [first, last) and converts them a storage
+//  word at a time, funnel-shifting out the bases before first that share
+//  its byte.
+twobit_sequence twobit_reader::fetch(std::string_view name, size_type first, size_type last)
+{
+  constexpr unsigned bases_per_word = base_vector::bases_per_word;
+  constexpr unsigned bits_per_word = bases_per_word * 2;
+  constexpr unsigned bytes_per_word = sizeof(__storage_type);
+
+  __entry& e = __find(name);
+  last = std::min(last, e.dna_size);
+  if (first > last)
+    throw std::out_of_range("twobit_reader: empty region of " + e.name);
+
+  twobit_sequence r;
+  r.name = e.name;
+  __clip(e.n_blocks, first, last, r.n_blocks);
+  __clip(e.mask_blocks, first, last, r.mask_blocks);
+  if (first == last)
+    return r;
+
+  const size_type b0 = first / 4;
+  const size_type nbytes = (last + 3) / 4 - b0;
+  std::vector<unsigned char> buf(nbytes);
+  is_.seekg(static_cast<std::streamoff>(e.dna_offset + b0));
+  __read(buf.data(), nbytes);
+
+  const size_type n = last - first;
+  const size_type nw = (n - 1) / bases_per_word + 1;
+  const unsigned s = 2 * (first % 4);
+  auto load = [&](size_type i) -> __storage_type
+  {
+    const size_type k = i * bytes_per_word;
+    return k < nbytes ? __twobit_to_word(__load_bytes<__storage_type>(buf.data() + k,
+                                                                     std::min<size_type>(bytes_per_word, nbytes - k)))
+                      : 0;
+  };
+  r.seq.resize(nw * bases_per_word);
+  __storage_type* out = r.seq.data();
+  __storage_type cur = load(0);
+  for (size_type i = 0; i != nw; ++i)
+  {
+    const __storage_type next = load(i + 1);
+    out[i] = s == 0 ? cur : cur >> s | next << (bits_per_word - s);
+    cur = next;
+  }
+  if (n % bases_per_word != 0)
+    out[nw - 1] &= ~(~__storage_type(0) << (2 * (n % bases_per_word)));
+  r.seq.resize(n);
+  return r;
+}
+
+twobit_sequence twobit_reader::fetch(std::string_view region)
+{
+  // names may contain ':', so only a suffix that parses as a range is one
+  const auto colon = region.rfind(':');
+  if (colon != std::string_view::npos)
+  {
+    std::string range;
+    for (char c : region.substr(colon + 1))
+      if (c != ',')
+        range.push_back(c);
+    const char* p = range.data();
+    const char* end = p + range.size();
+    size_type start = 0, stop = std::numeric_limits<size_type>::max();
+    auto [q, ec] = std::from_chars(p, end, start);
+    if (ec == std::errc() && start != 0)
+    {
+      if (q == end)
+        return fetch(region.substr(0, colon), start - 1, stop);
+      if (*q == '-')
+      {
+        auto [q2, ec2] = std::from_chars(q + 1, end, stop);
+        if (ec2 == std::errc() && q2 == end)
+          return fetch(region.substr(0, colon), start - 1, stop);
+      }
+    }
+  }
+  return read(region);
+}
+
+void write_twobit(std::ostream& os, const std::vector<twobit_sequence>& seqs)
+{
+  typedef base_vector::__storage_type __storage_type;
+  constexpr unsigned bytes_per_word = sizeof(__storage_type);
+
+  auto put_u32 = [&os](std::uint64_t x)
+  {
+    const std::uint32_t y = static_cast<std::uint32_t>(x);
+    os.write(reinterpret_cast<const char*>(&y), sizeof(y));
+  };
+  auto put_u64 = [&os](std::uint64_t x) {os.write(reinterpret_cast<const char*>(&x), sizeof(x));};
+  auto put_blocks = [&](const auto& b)
+  {
+    put_u32(b.size());
+    for (const auto& blk : b)
+      put_u32(blk.first);
+    for (const auto& blk : b)
+      put_u32(blk.second - blk.first);
+  };
+
+  std::uint64_t index_size = 0, data_size = 0;
+  for (const auto& s : seqs)
+  {
+    if (s.name.size() > 255)
+      throw std::length_error("write_twobit: sequence name longer than 255");
+    if (s.seq.size() > 0xFFFFFFFF)
+      throw std::length_error("write_twobit: sequence longer than 2^32 - 1");
+    index_size += 1 + s.name.size() + 4;
+    data_size += 16 + 8 * (s.n_blocks.size() + s.mask_blocks.size()) + (s.seq.size() + 3) / 4;
+  }
+  // version 1 widens the offsets when the file outgrows 32 bits
+  const std::uint32_t version = 16 + index_size + data_size > 0xFFFFFFFF;
+  if (version == 1)
+    index_size += 4 * seqs.size();
+
+  put_u32(__twobit_signature);
+  put_u32(version);
+  put_u32(seqs.size());
+  put_u32(0);
+  std::uint64_t offset = 16 + index_size;
+  for (const auto& s : seqs)
+  {
+    const unsigned char n = static_cast<unsigned char>(s.name.size());
+    os.put(static_cast<char>(n));
+    os.write(s.name.data(), n);
+    if (version == 0)
+      put_u32(offset);
+    else
+      put_u64(offset);
+    offset += 16 + 8 * (s.n_blocks.size() + s.mask_blocks.size()) + (s.seq.size() + 3) / 4;
+  }
+
+  for (const auto& s : seqs)
+  {
+    put_u32(s.seq.size());
+    put_blocks(s.n_blocks);
+    put_blocks(s.mask_blocks);
+    put_u32(0);
+
+    const __storage_type* seg = s.seq.data();
+    std::size_t nbytes = (s.seq.size() + 3) / 4;
+    unsigned char buf[bytes_per_word];
+    for (; nbytes != 0; ++seg)
+    {
+      const __storage_type w = __word_to_twobit(*seg);
+      const std::size_t k = std::min<std::size_t>(bytes_per_word, nbytes);
+      for (std::size_t j = 0; j != k; ++j)
+        buf[j] = static_cast<unsigned char>(w >> (CHAR_BIT * j));
+      nbytes -= k;
+      // the slots past the last base are written as T
+      if (nbytes == 0 && s.seq.size() % 4 != 0)
+        buf[k - 1] &= static_cast<unsigned char>(0xFF << (8 - 2 * (s.seq.size() % 4)));
+      os.write(reinterpret_cast<const char*>(buf), static_cast<std::streamsize>(k));
+    }
+  }
+}
+
+void write_twobit(const std::string& path, const std::vector<twobit_sequence>& seqs)
+{
+  std::ofstream os(path, std::ios::binary);
+  write_twobit(os, seqs);
+  if (!os.flush())
+    throw std::runtime_error("write_twobit: cannot write " + path);
+}
+
+}
+
+#endif //BIOVOLTRON_TWOBIT
@@ -105,6 +105,9 @@ public:
     reference       back();
     const_reference back() const;
     
+    storage_pointer       data() noexcept;
+    const_storage_pointer data() const noexcept;
+    
     void push_back(const value_type& x);
     template <class... Args> reference emplace_back(Args&&... args);  // C++14; reference in C++17
     void pop_back();
@@ -129,6 +132,12 @@ public:
                  allocator_traits<allocator_type>::is_always_equal::value);  // C++17
  
     void flip() noexcept;
+    size_type count(value_type x) const noexcept;
+    array<size_type, 4> histogram() const noexcept;
+
+    // n <= elements per word from pos in the low bits, element pos lowest
+    storage_type extract(size_type pos, unsigned n) const noexcept;
+    void deposit(size_type pos, unsigned n, storage_type bits) noexcept;
     
     bool __invariants() const;
 };
@@ -140,17 +149,25 @@ public:
 #include <cassert>
 #include <cstdint>
 #include <type_traits>
+#include <concepts>
 #include <iterator>
 #include <limits>
 #include <climits>
 #include <boost/compressed_pair.hpp>
 #include <algorithm>
+#include <array>
+#include <utility>
 
 namespace std
 {
     struct uint2_t;
 }
 
+namespace biovoltron
+{
+    template <class Iterator> struct segmented_iterator_traits;
+}
+
 namespace detail
 {
     typedef uint8_t uint2_t;
@@ -245,6 +262,7 @@ private:
     typedef std::conditional_t<IsConst, typename Cp::__const_storage_pointer,
                                         typename Cp::__storage_pointer> __storage_pointer;
     static const unsigned uint2_per_word = Cp::uint2_per_word;
+    static const unsigned bits_per_word  = uint2_per_word * 2;
 
     __storage_pointer seg_;
     unsigned          pos_;
@@ -363,6 +381,52 @@ private:
     friend class __uint2_reference<Cp>;
     friend class __uint2_const_reference<Cp>;
     friend class __uint2_iterator<Cp, true>;
+    friend struct biovoltron::segmented_iterator_traits<__uint2_iterator>;
+
+    template <class Dp, bool IC>
+    friend __uint2_iterator<Dp, false> __copy_aligned(__uint2_iterator<Dp, IC> first,
+                                                      __uint2_iterator<Dp, IC> last,
+                                                      __uint2_iterator<Dp, false> result);
+    template <class Dp, bool IC>
+    friend __uint2_iterator<Dp, false> __copy_unaligned(__uint2_iterator<Dp, IC> first,
+                                                        __uint2_iterator<Dp, IC> last,
+                                                        __uint2_iterator<Dp, false> result);
+    template <class Dp, bool IC>
+    friend __uint2_iterator<Dp, false> __copy(__uint2_iterator<Dp, IC> first,
+                                              __uint2_iterator<Dp, IC> last,
+                                              __uint2_iterator<Dp, false> result);
+    template <class Dp, bool IC>
+    friend __uint2_iterator<Dp, false> __copy_backward_aligned(__uint2_iterator<Dp, IC> first,
+                                                               __uint2_iterator<Dp, IC> last,
+                                                               __uint2_iterator<Dp, false> result);
+    template <class Dp, bool IC>
+    friend __uint2_iterator<Dp, false> __copy_backward_unaligned(__uint2_iterator<Dp, IC> first,
+                                                                 __uint2_iterator<Dp, IC> last,
+                                                                 __uint2_iterator<Dp, false> result);
+    template <class Dp, bool IC>
+    friend __uint2_iterator<Dp, false> __copy_backward(__uint2_iterator<Dp, IC> first,
+                                                       __uint2_iterator<Dp, IC> last,
+                                                       __uint2_iterator<Dp, false> result);
+    template <class Dp>
+    friend void __fill_n(__uint2_iterator<Dp, false> first, typename Dp::size_type n, uint2_t x);
+    template <class Dp, bool IC>
+    friend typename __uint2_iterator<Dp, IC>::difference_type
+    __count(__uint2_iterator<Dp, IC> first, typename Dp::size_type n, uint2_t x);
+    template <class Dp, bool IC>
+    friend std::array<typename Dp::size_type, 4>
+    __histogram(__uint2_iterator<Dp, IC> first, typename Dp::size_type n);
+    template <class Dp, bool IC1, bool IC2>
+    friend std::pair<__uint2_iterator<Dp, IC1>, __uint2_iterator<Dp, IC2>>
+    __mismatch(__uint2_iterator<Dp, IC1> first1, __uint2_iterator<Dp, IC1> last1,
+               __uint2_iterator<Dp, IC2> first2);
+    template <class Dp, bool IC1, bool IC2>
+    friend bool __equal_aligned(__uint2_iterator<Dp, IC1> first1, __uint2_iterator<Dp, IC1> last1,
+                                __uint2_iterator<Dp, IC2> first2);
+    template <class Dp, bool IC1, bool IC2>
+    friend bool __equal(__uint2_iterator<Dp, IC1> first1, __uint2_iterator<Dp, IC1> last1,
+                        __uint2_iterator<Dp, IC2> first2);
+    template <class Dp, bool IC>
+    friend std::size_t __hash(__uint2_iterator<Dp, IC> first, typename Dp::size_type n) noexcept;
 };
 
 template <class Cp>
@@ -392,6 +456,682 @@ swap(__uint2_reference<Cp> x, uint2_t& y) noexcept
     y = t;
 }
 
+template <class T>
+inline
+unsigned
+__popcount(T x) noexcept
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    unsigned r = 0;
+    for (; x; x &= x - 1)
+        ++r;
+    return r;
+#endif
+}
+
+//  Precondition:  x != 0
+template <class T>
+inline
+unsigned
+__countr_zero(T x) noexcept
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned r = 0;
+    for (; !(x & 1); x >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+//  Returns the nb bits starting at bit ctz of seg in the low bits of a word,
+//  reading the following word only when the range spills into it.
+//  Precondition:  0 < nb <= bits per word
+template <class StorageType, class StoragePointer>
+inline
+StorageType
+__load_word(StoragePointer seg, unsigned ctz, unsigned nb) noexcept
+{
+    const unsigned bits_per_word = sizeof(StorageType) * CHAR_BIT;
+    StorageType w = *seg >> ctz;
+    if (ctz + nb > bits_per_word)
+        w |= seg[1] << (bits_per_word - ctz);
+    if (nb < bits_per_word)
+        w &= ~(~StorageType(0) << nb);
+    return w;
+}
+
+//  Writes the low nb bits of w at bit ctz of seg, spilling into the
+//  following word when the range crosses it.
+//  Precondition:  0 < nb <= bits per word
+template <class StorageType, class StoragePointer>
+inline
+void
+__store_word(StoragePointer seg, unsigned ctz, unsigned nb, StorageType w) noexcept
+{
+    const unsigned bits_per_word = sizeof(StorageType) * CHAR_BIT;
+    const StorageType m = nb < bits_per_word ? ~(~StorageType(0) << nb) : ~StorageType(0);
+    w &= m;
+    *seg = (*seg & ~(m << ctz)) | w << ctz;
+    if (ctz + nb > bits_per_word)
+    {
+        const unsigned s = bits_per_word - ctz;
+        seg[1] = (seg[1] & ~(m >> s)) | w >> s;
+    }
+}
+
+// copy
+
+template <class Cp, bool IsConst>
+__uint2_iterator<Cp, false>
+__copy_aligned(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last,
+               __uint2_iterator<Cp, false> result)
+{
+    typedef __uint2_iterator<Cp, IsConst>  In;
+    typedef typename In::difference_type   difference_type;
+    typedef typename In::__storage_type    __storage_type;
+    const int bits_per_word = In::bits_per_word;
+    difference_type n = (last - first) * 2;
+    if (n > 0)
+    {
+        // do first word
+        if (first.pos_ != 0)
+        {
+            unsigned ctz = first.pos_ * 2;
+            unsigned clz = bits_per_word - ctz;
+            difference_type dn = std::min(static_cast<difference_type>(clz), n);
+            n -= dn;
+            __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+            __storage_type b = *first.seg_ & m;
+            *result.seg_ &= ~m;
+            *result.seg_ |= b;
+            result.seg_ += (dn + ctz) / bits_per_word;
+            result.pos_ = static_cast<unsigned>((dn + ctz) % bits_per_word) / 2;
+            ++first.seg_;
+            // first.pos_ = 0;
+        }
+        // first.pos_ == 0;
+        // do middle words
+        difference_type nw = n / bits_per_word;
+        std::copy_n(first.seg_, nw, result.seg_);
+        n -= nw * bits_per_word;
+        result.seg_ += nw;
+        // do last word
+        if (n > 0)
+        {
+            first.seg_ += nw;
+            __storage_type m = ~__storage_type(0) >> (bits_per_word - n);
+            __storage_type b = *first.seg_ & m;
+            *result.seg_ &= ~m;
+            *result.seg_ |= b;
+            result.pos_ = static_cast<unsigned>(n / 2);
+        }
+    }
+    return result;
+}
+
+template <class Cp, bool IsConst>
+__uint2_iterator<Cp, false>
+__copy_unaligned(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last,
+                 __uint2_iterator<Cp, false> result)
+{
+    typedef __uint2_iterator<Cp, IsConst>  In;
+    typedef typename In::difference_type   difference_type;
+    typedef typename In::__storage_type    __storage_type;
+    const int bits_per_word = In::bits_per_word;
+    difference_type n = (last - first) * 2;
+    if (n > 0)
+    {
+        unsigned ctz_f = first.pos_ * 2;
+        unsigned ctz_r = result.pos_ * 2;
+        // do first word
+        if (ctz_f != 0)
+        {
+            unsigned clz_f = bits_per_word - ctz_f;
+            difference_type dn = std::min(static_cast<difference_type>(clz_f), n);
+            n -= dn;
+            __storage_type m = (~__storage_type(0) << ctz_f) & (~__storage_type(0) >> (clz_f - dn));
+            __storage_type b = *first.seg_ & m;
+            unsigned clz_r = bits_per_word - ctz_r;
+            difference_type ddn = std::min(dn, static_cast<difference_type>(clz_r));
+            m = (~__storage_type(0) << ctz_r) & (~__storage_type(0) >> (clz_r - ddn));
+            *result.seg_ &= ~m;
+            if (ctz_r > ctz_f)
+                *result.seg_ |= b << (ctz_r - ctz_f);
+            else
+                *result.seg_ |= b >> (ctz_f - ctz_r);
+            result.seg_ += (ddn + ctz_r) / bits_per_word;
+            ctz_r = static_cast<unsigned>((ddn + ctz_r) % bits_per_word);
+            dn -= ddn;
+            if (dn > 0)
+            {
+                m = ~__storage_type(0) >> (bits_per_word - dn);
+                *result.seg_ &= ~m;
+                *result.seg_ |= b >> (ctz_f + ddn);
+                ctz_r = static_cast<unsigned>(dn);
+            }
+            ++first.seg_;
+            // ctz_f = 0;
+        }
+        // ctz_f == 0;
+        // do middle words
+        unsigned clz_r = bits_per_word - ctz_r;
+        __storage_type m = ~__storage_type(0) << ctz_r;
+        for (; n >= bits_per_word; n -= bits_per_word, ++first.seg_)
+        {
+            __storage_type b = *first.seg_;
+            *result.seg_ &= ~m;
+            *result.seg_ |= b << ctz_r;
+            ++result.seg_;
+            *result.seg_ &= m;
+            *result.seg_ |= b >> clz_r;
+        }
+        // do last word
+        if (n > 0)
+        {
+            m = ~__storage_type(0) >> (bits_per_word - n);
+            __storage_type b = *first.seg_ & m;
+            difference_type dn = std::min(n, static_cast<difference_type>(clz_r));
+            m = (~__storage_type(0) << ctz_r) & (~__storage_type(0) >> (clz_r - dn));
+            *result.seg_ &= ~m;
+            *result.seg_ |= b << ctz_r;
+            result.seg_ += (dn + ctz_r) / bits_per_word;
+            ctz_r = static_cast<unsigned>((dn + ctz_r) % bits_per_word);
+            n -= dn;
+            if (n > 0)
+            {
+                m = ~__storage_type(0) >> (bits_per_word - n);
+                *result.seg_ &= ~m;
+                *result.seg_ |= b >> dn;
+                ctz_r = static_cast<unsigned>(n);
+            }
+        }
+        result.pos_ = ctz_r / 2;
+    }
+    return result;
+}
+
+template <class Cp, bool IsConst>
+inline
+__uint2_iterator<Cp, false>
+__copy(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last,
+       __uint2_iterator<Cp, false> result)
+{
+    if (first.pos_ == result.pos_)
+        return __copy_aligned(first, last, result);
+    return __copy_unaligned(first, last, result);
+}
+
+// copy_backward
+
+template <class Cp, bool IsConst>
+__uint2_iterator<Cp, false>
+__copy_backward_aligned(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last,
+                        __uint2_iterator<Cp, false> result)
+{
+    typedef __uint2_iterator<Cp, IsConst>  In;
+    typedef typename In::difference_type   difference_type;
+    typedef typename In::__storage_type    __storage_type;
+    const int bits_per_word = In::bits_per_word;
+    difference_type n = (last - first) * 2;
+    if (n > 0)
+    {
+        // do first word
+        if (last.pos_ != 0)
+        {
+            unsigned ctz = last.pos_ * 2;
+            difference_type dn = std::min(static_cast<difference_type>(ctz), n);
+            n -= dn;
+            unsigned clz = bits_per_word - ctz;
+            __storage_type m = (~__storage_type(0) << (ctz - dn)) & (~__storage_type(0) >> clz);
+            __storage_type b = *last.seg_ & m;
+            *result.seg_ &= ~m;
+            *result.seg_ |= b;
+            result.pos_ = static_cast<unsigned>(ctz - dn) / 2;
+            // last.pos_ = 0
+        }
+        // last.pos_ == 0 || n == 0
+        // result.pos_ == 0 || n == 0
+        // do middle words
+        difference_type nw = n / bits_per_word;
+        std::copy_backward(last.seg_ - nw, last.seg_, result.seg_);
+        result.seg_ -= nw;
+        last.seg_ -= nw;
+        n -= nw * bits_per_word;
+        // do last word
+        if (n > 0)
+        {
+            __storage_type m = ~__storage_type(0) << (bits_per_word - n);
+            __storage_type b = *--last.seg_ & m;
+            *--result.seg_ &= ~m;
+            *result.seg_ |= b;
+            result.pos_ = static_cast<unsigned>(bits_per_word - n) / 2;
+        }
+    }
+    return result;
+}
+
+template <class Cp, bool IsConst>
+__uint2_iterator<Cp, false>
+__copy_backward_unaligned(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last,
+                          __uint2_iterator<Cp, false> result)
+{
+    typedef __uint2_iterator<Cp, IsConst>  In;
+    typedef typename In::difference_type   difference_type;
+    typedef typename In::__storage_type    __storage_type;
+    const int bits_per_word = In::bits_per_word;
+    difference_type n = (last - first) * 2;
+    if (n > 0)
+    {
+        unsigned ctz_l = last.pos_ * 2;
+        unsigned ctz_r = result.pos_ * 2;
+        // do first word
+        if (ctz_l != 0)
+        {
+            difference_type dn = std::min(static_cast<difference_type>(ctz_l), n);
+            n -= dn;
+            unsigned clz_l = bits_per_word - ctz_l;
+            __storage_type m = (~__storage_type(0) << (ctz_l - dn)) & (~__storage_type(0) >> clz_l);
+            __storage_type b = *last.seg_ & m;
+            difference_type ddn = std::min(dn, static_cast<difference_type>(ctz_r));
+            if (ddn > 0)
+            {
+                m = (~__storage_type(0) << (ctz_r - ddn)) & (~__storage_type(0) >> (bits_per_word - ctz_r));
+                *result.seg_ &= ~m;
+                if (ctz_r > ctz_l)
+                    *result.seg_ |= b << (ctz_r - ctz_l);
+                else
+                    *result.seg_ |= b >> (ctz_l - ctz_r);
+                ctz_r -= static_cast<unsigned>(ddn);
+                dn -= ddn;
+            }
+            if (dn > 0)
+            {
+                // ctz_r == 0
+                --result.seg_;
+                ctz_r = static_cast<unsigned>(bits_per_word - dn);
+                m = ~__storage_type(0) << ctz_r;
+                *result.seg_ &= ~m;
+                ctz_l -= static_cast<unsigned>(dn + ddn);
+                *result.seg_ |= b << (ctz_r - ctz_l);
+            }
+            // ctz_l = 0
+        }
+        // ctz_l == 0 || n == 0
+        // ctz_r != 0 || n == 0
+        // do middle words
+        unsigned clz_r = bits_per_word - ctz_r;
+        __storage_type m = ~(~__storage_type(0) << ctz_r);
+        for (; n >= bits_per_word; n -= bits_per_word)
+        {
+            __storage_type b = *--last.seg_;
+            *result.seg_ &= ~m;
+            *result.seg_ |= b >> clz_r;
+            *--result.seg_ &= m;
+            *result.seg_ |= b << ctz_r;
+        }
+        // do last word
+        if (n > 0)
+        {
+            m = ~__storage_type(0) << (bits_per_word - n);
+            __storage_type b = *--last.seg_ & m;
+            difference_type dn = std::min(n, static_cast<difference_type>(ctz_r));
+            m = (~__storage_type(0) << (ctz_r - dn)) & (~__storage_type(0) >> clz_r);
+            *result.seg_ &= ~m;
+            *result.seg_ |= b >> clz_r;
+            ctz_r -= static_cast<unsigned>(dn);
+            n -= dn;
+            if (n > 0)
+            {
+                // ctz_r == 0
+                --result.seg_;
+                ctz_r = static_cast<unsigned>(bits_per_word - n);
+                m = ~__storage_type(0) << ctz_r;
+                *result.seg_ &= ~m;
+                *result.seg_ |= b << dn;
+            }
+        }
+        result.pos_ = ctz_r / 2;
+    }
+    return result;
+}
+
+template <class Cp, bool IsConst>
+inline
+__uint2_iterator<Cp, false>
+__copy_backward(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last,
+                __uint2_iterator<Cp, false> result)
+{
+    if (last.pos_ == result.pos_)
+        return __copy_backward_aligned(first, last, result);
+    return __copy_backward_unaligned(first, last, result);
+}
+
+// fill_n
+
+template <class Cp>
+void
+__fill_n(__uint2_iterator<Cp, false> first, typename Cp::size_type n, uint2_t x)
+{
+    typedef __uint2_iterator<Cp, false>  It;
+    typedef typename It::difference_type difference_type;
+    typedef typename It::__storage_type  __storage_type;
+    const int bits_per_word = It::bits_per_word;
+    // x replicated into every 2-bit slot of a word
+    const __storage_type pattern = ~__storage_type(0) / 3 * x;
+    auto nb = static_cast<difference_type>(n * 2);
+    // do first partial word
+    if (first.pos_ != 0)
+    {
+        unsigned ctz = first.pos_ * 2;
+        unsigned clz = bits_per_word - ctz;
+        difference_type dn = std::min(static_cast<difference_type>(clz), nb);
+        __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+        *first.seg_ = (*first.seg_ & ~m) | (pattern & m);
+        nb -= dn;
+        ++first.seg_;
+    }
+    // do middle whole words
+    difference_type nw = nb / bits_per_word;
+    std::fill_n(first.seg_, nw, pattern);
+    nb -= nw * bits_per_word;
+    // do last partial word
+    if (nb > 0)
+    {
+        first.seg_ += nw;
+        __storage_type m = ~__storage_type(0) >> (bits_per_word - nb);
+        *first.seg_ = (*first.seg_ & ~m) | (pattern & m);
+    }
+}
+
+// count
+
+template <class Cp, bool IsConst>
+typename __uint2_iterator<Cp, IsConst>::difference_type
+__count(__uint2_iterator<Cp, IsConst> first, typename Cp::size_type n, uint2_t x)
+{
+    typedef __uint2_iterator<Cp, IsConst> It;
+    typedef typename It::difference_type  difference_type;
+    typedef typename It::__storage_type   __storage_type;
+    const int bits_per_word = It::bits_per_word;
+    // low bit of every 2-bit slot
+    const __storage_type lo_bits = ~__storage_type(0) / 3;
+    const __storage_type pattern = lo_bits * x;
+    difference_type r = 0;
+    auto nb = static_cast<difference_type>(n * 2);
+    // do first partial word
+    if (first.pos_ != 0)
+    {
+        unsigned ctz = first.pos_ * 2;
+        unsigned clz = bits_per_word - ctz;
+        difference_type dn = std::min(static_cast<difference_type>(clz), nb);
+        __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+        __storage_type e = ~(*first.seg_ ^ pattern);
+        r += __popcount(e & (e >> 1) & lo_bits & m);
+        nb -= dn;
+        ++first.seg_;
+    }
+    // do middle whole words
+    for (; nb >= bits_per_word; ++first.seg_, nb -= bits_per_word)
+    {
+        __storage_type e = ~(*first.seg_ ^ pattern);
+        r += __popcount(e & (e >> 1) & lo_bits);
+    }
+    // do last partial word
+    if (nb > 0)
+    {
+        __storage_type m = ~__storage_type(0) >> (bits_per_word - nb);
+        __storage_type e = ~(*first.seg_ ^ pattern);
+        r += __popcount(e & (e >> 1) & lo_bits & m);
+    }
+    return r;
+}
+
+// histogram
+
+//  Counts every 2-bit value in [first, first + n) in one pass.
+//  Per word the high and low bit planes are popcounted separately,
+//  together with their intersection (the 3s); the 1s, 2s and 0s follow.
+template <class Cp, bool IsConst>
+std::array<typename Cp::size_type, 4>
+__histogram(__uint2_iterator<Cp, IsConst> first, typename Cp::size_type n)
+{
+    typedef __uint2_iterator<Cp, IsConst> It;
+    typedef typename It::difference_type  difference_type;
+    typedef typename It::__storage_type   __storage_type;
+    typedef typename Cp::size_type        size_type;
+    const int bits_per_word = It::bits_per_word;
+    const __storage_type lo_bits = ~__storage_type(0) / 3;
+    size_type hi = 0, lo = 0, both = 0;
+    auto nb = static_cast<difference_type>(n * 2);
+    // do first partial word
+    if (first.pos_ != 0)
+    {
+        unsigned ctz = first.pos_ * 2;
+        unsigned clz = bits_per_word - ctz;
+        difference_type dn = std::min(static_cast<difference_type>(clz), nb);
+        __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+        __storage_type w = *first.seg_ & m;
+        __storage_type h = (w >> 1) & lo_bits, l = w & lo_bits;
+        hi += __popcount(h);
+        lo += __popcount(l);
+        both += __popcount(h & l);
+        nb -= dn;
+        ++first.seg_;
+    }
+    // do middle whole words
+    for (; nb >= bits_per_word; ++first.seg_, nb -= bits_per_word)
+    {
+        __storage_type w = *first.seg_;
+        __storage_type h = (w >> 1) & lo_bits, l = w & lo_bits;
+        hi += __popcount(h);
+        lo += __popcount(l);
+        both += __popcount(h & l);
+    }
+    // do last partial word
+    if (nb > 0)
+    {
+        __storage_type m = ~__storage_type(0) >> (bits_per_word - nb);
+        __storage_type w = *first.seg_ & m;
+        __storage_type h = (w >> 1) & lo_bits, l = w & lo_bits;
+        hi += __popcount(h);
+        lo += __popcount(l);
+        both += __popcount(h & l);
+    }
+    return {n - hi - lo + both, lo - both, hi - both, both};
+}
+
+template <class Cp, bool IsConst>
+inline
+std::array<typename Cp::size_type, 4>
+histogram(__uint2_iterator<Cp, IsConst> first, __uint2_iterator<Cp, IsConst> last)
+{
+    return __histogram(first, static_cast<typename Cp::size_type>(last - first));
+}
+
+// mismatch
+
+//  Compares a word's worth of elements at a time; the first differing
+//  element is the lowest differing 2-bit slot of the xor.
+template <class Cp, bool IC1, bool IC2>
+std::pair<__uint2_iterator<Cp, IC1>, __uint2_iterator<Cp, IC2>>
+__mismatch(__uint2_iterator<Cp, IC1> first1, __uint2_iterator<Cp, IC1> last1,
+           __uint2_iterator<Cp, IC2> first2)
+{
+    typedef __uint2_iterator<Cp, IC1>    It;
+    typedef typename It::difference_type difference_type;
+    typedef typename It::__storage_type  __storage_type;
+    const int bits_per_word = It::bits_per_word;
+    difference_type n = (last1 - first1) * 2;
+    unsigned ctz1 = first1.pos_ * 2;
+    unsigned ctz2 = first2.pos_ * 2;
+    // do whole words
+    for (; n >= bits_per_word; n -= bits_per_word, ++first1.seg_, ++first2.seg_)
+    {
+        __storage_type d = __load_word<__storage_type>(first1.seg_, ctz1, bits_per_word)
+                         ^ __load_word<__storage_type>(first2.seg_, ctz2, bits_per_word);
+        if (d != 0)
+        {
+            difference_type i = __countr_zero(d) / 2;
+            return {first1 + i, first2 + i};
+        }
+    }
+    // do last partial word
+    if (n > 0)
+    {
+        auto nb = static_cast<unsigned>(n);
+        __storage_type d = __load_word<__storage_type>(first1.seg_, ctz1, nb)
+                         ^ __load_word<__storage_type>(first2.seg_, ctz2, nb);
+        difference_type i = d != 0 ? __countr_zero(d) / 2 : n / 2;
+        return {first1 + i, first2 + i};
+    }
+    return {first1, first2};
+}
+
+// equal
+
+template <class Cp, bool IC1, bool IC2>
+bool
+__equal_aligned(__uint2_iterator<Cp, IC1> first1, __uint2_iterator<Cp, IC1> last1,
+                __uint2_iterator<Cp, IC2> first2)
+{
+    typedef __uint2_iterator<Cp, IC1>    It;
+    typedef typename It::difference_type difference_type;
+    typedef typename It::__storage_type  __storage_type;
+    const int bits_per_word = It::bits_per_word;
+    difference_type n = (last1 - first1) * 2;
+    if (n > 0)
+    {
+        // do first word
+        if (first1.pos_ != 0)
+        {
+            unsigned ctz = first1.pos_ * 2;
+            unsigned clz = bits_per_word - ctz;
+            difference_type dn = std::min(static_cast<difference_type>(clz), n);
+            n -= dn;
+            __storage_type m = (~__storage_type(0) << ctz) & (~__storage_type(0) >> (clz - dn));
+            if ((*first2.seg_ & m) != (*first1.seg_ & m))
+                return false;
+            ++first2.seg_;
+            ++first1.seg_;
+            // first1.pos_ = 0;
+            // first2.pos_ = 0;
+        }
+        // do middle words
+        difference_type nw = n / bits_per_word;
+        if (!std::equal(first1.seg_, first1.seg_ + nw, first2.seg_))
+            return false;
+        n -= nw * bits_per_word;
+        // do last word
+        if (n > 0)
+        {
+            first1.seg_ += nw;
+            first2.seg_ += nw;
+            __storage_type m = ~__storage_type(0) >> (bits_per_word - n);
+            if ((*first2.seg_ & m) != (*first1.seg_ & m))
+                return false;
+        }
+    }
+    return true;
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline
+bool
+__equal(__uint2_iterator<Cp, IC1> first1, __uint2_iterator<Cp, IC1> last1,
+        __uint2_iterator<Cp, IC2> first2)
+{
+    if (first1.pos_ == first2.pos_)
+        return __equal_aligned(first1, last1, first2);
+    return __mismatch(first1, last1, first2).first == last1;
+}
+
+}
+
+namespace std
+{
+
+template <class Cp, bool IsConst>
+inline
+detail::__uint2_iterator<Cp, false>
+copy(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last,
+     detail::__uint2_iterator<Cp, false> result)
+{
+    return detail::__copy(first, last, result);
+}
+
+template <class Cp, bool IsConst>
+inline
+detail::__uint2_iterator<Cp, false>
+copy_backward(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last,
+              detail::__uint2_iterator<Cp, false> result)
+{
+    return detail::__copy_backward(first, last, result);
+}
+
+// The count and the value are template parameters so that these stay more
+// specialized than the generic fill_n and fill for integer literals too.
+template <class Cp, std::integral Size, std::integral T>
+inline
+detail::__uint2_iterator<Cp, false>
+fill_n(detail::__uint2_iterator<Cp, false> first, Size n, const T& x)
+{
+    if (n > 0)
+        detail::__fill_n(first, static_cast<typename Cp::size_type>(n), static_cast<detail::uint2_t>(x));
+    return n > 0 ? first + n : first;
+}
+
+template <class Cp, std::integral T>
+inline
+void
+fill(detail::__uint2_iterator<Cp, false> first, detail::__uint2_iterator<Cp, false> last, const T& x)
+{
+    std::fill_n(first, static_cast<typename Cp::size_type>(last - first), x);
+}
+
+// x is a template parameter so that this stays more specialized than the
+// generic count for integer literals too; a value no uint2_t can hold
+// counts 0.
+template <class Cp, bool IsConst, std::integral T>
+inline
+typename detail::__uint2_iterator<Cp, IsConst>::difference_type
+count(detail::__uint2_iterator<Cp, IsConst> first, detail::__uint2_iterator<Cp, IsConst> last, const T& x)
+{
+    if (std::cmp_less(x, 0) || std::cmp_greater(x, 3))
+        return 0;
+    return detail::__count(first, static_cast<typename Cp::size_type>(last - first), static_cast<detail::uint2_t>(x));
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline
+std::pair<detail::__uint2_iterator<Cp, IC1>, detail::__uint2_iterator<Cp, IC2>>
+mismatch(detail::__uint2_iterator<Cp, IC1> first1, detail::__uint2_iterator<Cp, IC1> last1,
+         detail::__uint2_iterator<Cp, IC2> first2)
+{
+    return detail::__mismatch(first1, last1, first2);
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline
+std::pair<detail::__uint2_iterator<Cp, IC1>, detail::__uint2_iterator<Cp, IC2>>
+mismatch(detail::__uint2_iterator<Cp, IC1> first1, detail::__uint2_iterator<Cp, IC1> last1,
+         detail::__uint2_iterator<Cp, IC2> first2, detail::__uint2_iterator<Cp, IC2> last2)
+{
+    return detail::__mismatch(first1, first1 + std::min(last1 - first1, last2 - first2), first2);
+}
+
+template <class Cp, bool IC1, bool IC2>
+inline
+bool
+equal(detail::__uint2_iterator<Cp, IC1> first1, detail::__uint2_iterator<Cp, IC1> last1,
+      detail::__uint2_iterator<Cp, IC2> first2)
+{
+    return detail::__equal(first1, last1, first2);
+}
+
 }
 
 namespace detail
@@ -615,6 +1355,9 @@ public:
     reference       back()        { return __make_ref(size_ - 1); }
     const_reference back()  const { return __make_ref(size_ - 1); }
 
+    __storage_pointer       data()       noexcept { return begin_; }
+    __const_storage_pointer data() const noexcept { return begin_; }
+
     void push_back(const value_type& x);
     template <class... Args>
     reference emplace_back(Args&&... args)
@@ -662,6 +1405,29 @@ public:
     void resize(size_type sz, value_type x = 0);
     void flip() noexcept;
 
+    size_type count(value_type x) const noexcept
+    { return static_cast<size_type>(std::count(begin(), end(), x)); }
+
+    std::array<size_type, 4> histogram() const noexcept
+    { return detail::histogram(begin(), end()); }
+
+    //  One funnel shift over the two words holding the range instead of a
+    //  proxy reference per element.
+    //  Precondition:  n <= uint2_per_word && pos + n <= size()
+    __storage_type extract(size_type pos, unsigned n) const noexcept
+    {
+        if (n == 0)
+            return 0;
+        return detail::__load_word<__storage_type>(begin_ + pos / uint2_per_word,
+                                                   pos % uint2_per_word * 2, n * 2);
+    }
+
+    void deposit(size_type pos, unsigned n, __storage_type bits) noexcept
+    {
+        if (n != 0)
+            detail::__store_word(begin_ + pos / uint2_per_word, pos % uint2_per_word * 2, n * 2, bits);
+    }
+
     bool __invariants() const;
 
 private:
@@ -1480,7 +2246,10 @@ template <class Allocator>
 bool
 operator< (const vector<uint2_t, Allocator>& x, const vector<uint2_t, Allocator>& y)
 {
-    return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+    auto p = std::mismatch(x.begin(), x.end(), y.begin(), y.end());
+    if (p.second == y.end())
+        return false;
+    return p.first == x.end() || *p.first < *p.second;
 }
 
 template <class Allocator>